@@ -11,14 +11,20 @@
 #include "Game.h"
 
 #define SHORTCUT_THRESHOLD      (MAX_SNAKE_LEN / 2)
+// A lone snake on its cycle always eats within one lap; two laps without
+// food means other snakes have pushed it into a loop
+#define STALL_LIMIT             (2 * MAX_SNAKE_LEN)
 
 typedef struct {
 	GAME_Engine_t *game_state;
-	C_COORDINATES_t ham_path[MAX_SNAKE_LEN];
-	uint8_t grid_to_index[DISPLAY_ROWS][DISPLAY_COLS];
+	uint8_t snake_id;                      // Snake this player steers
+	CELL_t ham_path[MAX_SNAKE_LEN];        // Cycle order -> cell id
+	CELL_INDEX_t grid_to_index[CELL_COUNT]; // Cell id -> cycle order
+	CELL_INDEX_t last_length;              // Stall watchdog
+	uint16_t stall_ticks;
 } ALGO_t;
 
-void ALGO_ctor(ALGO_t *const me, GAME_Engine_t *game_state);
+void ALGO_ctor(ALGO_t *const me, GAME_Engine_t *game_state, uint8_t snake_id);
 void ALGO_reset(ALGO_t *const me);
 key_action_e ALGO_get_action(ALGO_t *const me);
 
@@ -58,7 +58,7 @@ typedef struct {
     GAME_Engine_t *game;
     APP_UI_t *ui;
     INPUT_t *input;
-    ALGO_t *ai_player;           // AI player (always available)
+    ALGO_t *ai_players;          // AI players, one per snake (GAME_MAX_SNAKES)
 
     // Control flags
     bool game_needs_tick;        // Should GAME_tick() be called this frame?
@@ -66,6 +66,12 @@ typedef struct {
 
     // Internal state tracking
     bool game_was_paused;        // Track if we manually paused the game
+
+    // Tick timing in CPU cycles, since the last APP_CONTROLLER_report()
+    uint32_t ai_cycles_sum;      // AI decisions for all snakes
+    uint32_t tick_cycles_sum;    // GAME_tick() (move + collisions)
+    uint32_t tick_cycles_max;
+    uint16_t tick_samples;
 } APP_Controller_t;
 
 /**
@@ -74,13 +80,14 @@ typedef struct {
  * @param game Pointer to initialized game engine
  * @param ui Pointer to initialized UI controller
  * @param input Pointer to initialized input handler
- * @param ai_player Pointer to initialized AI player
+ * @param ai_players Array of GAME_MAX_SNAKES initialized AI players,
+ *                   ai_players[i] steers snake i
  */
 void APP_CONTROLLER_ctor(APP_Controller_t *me,
                          GAME_Engine_t *game,
                          APP_UI_t *ui,
                          INPUT_t *input,
-                         ALGO_t *ai_player);
+                         ALGO_t *ai_players);
 
 /**
  * @brief Process input and route to appropriate subsystem
@@ -106,6 +113,14 @@ void APP_CONTROLLER_update(APP_Controller_t *me);
  */
 void APP_CONTROLLER_render(APP_Controller_t *me);
 
+/**
+ * @brief Log game tick and AI timing over UART, then reset (silent
+ *        without ticks)
+ * @param me Pointer to APP_Controller instance
+ * @note Call from the report task, not the tick path (UART output blocks)
+ */
+void APP_CONTROLLER_report(APP_Controller_t *me);
+
 /**
  * @brief Toggle between Manual and AI play modes
  * @param me Pointer to APP_Controller instance
@@ -114,6 +129,15 @@ void APP_CONTROLLER_render(APP_Controller_t *me);
  */
 void APP_CONTROLLER_toggle_play_mode(APP_Controller_t *me);
 
+/**
+ * @brief Change the number of snakes on the board (multi-snake mode)
+ * @param me Pointer to APP_Controller instance
+ * @param num_snakes Requested count, clamped to 1..GAME_MAX_SNAKES
+ * @note Restarts the game and regenerates every AI cycle
+ *       Triggered by LEFT/RIGHT in the settings menu
+ */
+void APP_CONTROLLER_set_num_snakes(APP_Controller_t *me, uint8_t num_snakes);
+
 /**
  * @brief Get current play mode
  * @param me Pointer to APP_Controller instance
@@ -17,15 +17,33 @@
 typedef enum {
     MENU_STATE_MAIN = 0,
     MENU_STATE_SETTINGS,
+    MENU_STATE_PERF,
     MENU_STATE_MAX
 } APP_UI_MenuState_e;
 
+// Performance HUD (PERF_PAGE): per metric a value and a history bar of
+// the last APP_UI_PERF_BAR_LEN samples, newest on the right. Each cell is
+// one of 8 CGRAM glyphs (1-8 rows lit) or a space for zero
+#define APP_UI_PERF_METRICS  4
+#define APP_UI_PERF_BAR_LEN  7
+#define APP_UI_GLYPH_BASE    0x08     // CGRAM glyph 0 (0x00 would end strings)
+
+// One HUD sample
+typedef struct {
+    uint32_t frame_us;               // Average frame time
+    uint32_t frame_budget_us;        // Render period: the time bars' scale
+    uint32_t wire_us;                // Average LED update (DISPLAY_update)
+    uint8_t cpu_pct;                 // Scheduler busy time
+    uint8_t i2c_pct;                 // Bus busy time
+} APP_UI_Perf_t;
+
 // Application UI Controller
 typedef struct {
     CHAR_CANVAS_t *canvas;           // Reference to canvas layer
     APP_UI_MenuState_e current_state;
     uint8_t selection_index;         // For menu item selection (future use)
     bool needs_refresh;              // Flag to trigger render
+    char perf_bars[APP_UI_PERF_METRICS][APP_UI_PERF_BAR_LEN + 1];
 } APP_UI_t;
 
 /* Public API */
@@ -61,6 +79,24 @@ void APP_UI_process_input(APP_UI_t * const me, key_action_e input);
  */
 void APP_UI_update_value(APP_UI_t * const me, CHAR_CANVAS_obj_e obj_type, const char * value);
 
+/**
+ * @brief Update a numeric UI object (right-aligned, no printf)
+ * @param me Pointer to APP_UI instance
+ * @param obj_type Object type to update
+ * @param value Value to display
+ * @note Cheap to call every frame: an unchanged value is a compare
+ */
+void APP_UI_update_int(APP_UI_t * const me, CHAR_CANVAS_obj_e obj_type, uint32_t value);
+
+/**
+ * @brief Add a sample to the performance HUD
+ * @param me Pointer to APP_UI instance
+ * @param perf Sample to show
+ * @note The HUD keeps its history while another page is shown. Bar cells
+ *       that keep their glyph are not sent to the LCD again.
+ */
+void APP_UI_update_perf(APP_UI_t * const me, const APP_UI_Perf_t * perf);
+
 /**
  * @brief Refresh the display if needed
  * @param me Pointer to APP_UI instance
@@ -9,6 +9,7 @@
 #define INC_CANVAS_H_
 
 #include "Display.h"
+#include "Cell.h"
 
 typedef struct {
 	uint8_t x,y;
@@ -16,7 +17,7 @@ typedef struct {
 
 typedef struct {
 	DISPLAY_t * display;
-	C_COORDINATES_t cursor;
+	CELL_t cursor;
 	PIXEL_t * canvas_buffer;
 }CANVAS_t;
 
@@ -28,6 +29,10 @@ void CANVAS_sync(CANVAS_t * const me);
 void CANVAS_draw_point(CANVAS_t *const me, C_COORDINATES_t postion, PIXEL_t color);
 void CANVAS_clear_point(CANVAS_t *const me, C_COORDINATES_t postion);
 
+// Packed cell id variants (no coordinate conversion, cell must be on the board)
+void CANVAS_draw_cell(CANVAS_t *const me, CELL_t cell, PIXEL_t color);
+void CANVAS_clear_cell(CANVAS_t *const me, CELL_t cell);
+
 void CANVAS_draw_rectangle(CANVAS_t *const me, C_COORDINATES_t postion,PIXEL_t color, uint8_t length, uint8_t breadth);
 void CANVAS_clear_rectangle(CANVAS_t *const me, C_COORDINATES_t postion, uint8_t length, uint8_t breadth);
 
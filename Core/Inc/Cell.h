@@ -0,0 +1,53 @@
+/*
+ * Cell.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_CELL_H_
+#define INC_CELL_H_
+
+#include <stdint.h>
+#include "Display.h"
+
+/*
+ * Packed cell ids: a board position is stored as one integer,
+ * id = y * DISPLAY_COLS + x, which is also its index in the canvas buffer.
+ *
+ * CELL_t holds a cell id or CELL_WALL, CELL_INDEX_t holds a count or an
+ * index in 0..CELL_COUNT (snake length, Hamiltonian cycle position).
+ * Both are one byte up to 255 cells and widen to 16 bits above that.
+ */
+#define CELL_COUNT  (DISPLAY_COLS * DISPLAY_ROWS)
+
+#if CELL_COUNT <= 255
+typedef uint8_t CELL_t;
+typedef uint8_t CELL_INDEX_t;
+#define CELL_WALL   ((CELL_t) UINT8_MAX)    // Sentinel: "off the board"
+#else
+typedef uint16_t CELL_t;
+typedef uint16_t CELL_INDEX_t;
+#define CELL_WALL   ((CELL_t) UINT16_MAX)   // Sentinel: "off the board"
+#endif
+
+#define CELL_ID(x, y)  ((CELL_t) (((y) * DISPLAY_COLS) + (x)))
+#define CELL_X(cell)   ((cell) % DISPLAY_COLS)
+#define CELL_Y(cell)   ((cell) / DISPLAY_COLS)
+
+_Static_assert(CELL_COUNT <= CELL_WALL, "CELL_t too narrow for the board");
+_Static_assert(CELL_COUNT <= (CELL_INDEX_t) -1, "CELL_INDEX_t too narrow for the board");
+
+// Neighbour directions, same order as key_action_e (UP, DOWN, LEFT, RIGHT)
+#define CELL_NUM_DIRS 4
+
+// Tables are emitted in blocks of 64 cells (see Cell.c)
+#define CELL_TABLE_SIZE (((CELL_COUNT + 63) / 64) * 64)
+
+/*
+ * Neighbour of every cell in each direction, CELL_WALL where the move
+ * leaves the board. Moving is a single load: next = CELL_NEIGHBOURS[c][dir]
+ */
+extern const CELL_t CELL_NEIGHBOURS[CELL_TABLE_SIZE][CELL_NUM_DIRS];
+
+#endif /* INC_CELL_H_ */
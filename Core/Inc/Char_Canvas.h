@@ -17,7 +17,18 @@ typedef enum {
     TOTAL_GAME_WINS,
     SNAKE_LEN,
     GAME_FPS,
+    CPU_LOAD,           // Busy % from scheduler idle time
+    I2C_ERRORS,         // Failed I2C transactions since boot
     PLAY_MODE_DISPLAY,  // ← NEW: Display "AI" or "MANUAL"
+    SNAKE_COUNT_DISPLAY, // Number of snakes in multi-snake mode
+    PERF_FRAME_US,      // Performance HUD: value and history bar per metric
+    PERF_FRAME_BAR,
+    PERF_CPU,
+    PERF_CPU_BAR,
+    PERF_WIRE_US,
+    PERF_WIRE_BAR,
+    PERF_I2C,
+    PERF_I2C_BAR,
     MAX_OBJECTS
 } CHAR_CANVAS_obj_e;
 
@@ -25,6 +36,7 @@ typedef enum {
 typedef enum {
     MAIN_PAGE = 0,
     SETTINGS_PAGE,
+    PERF_PAGE,
     TOTAL_PAGES
 } CHAR_CANVAS_Pages_e;
 
@@ -34,6 +46,9 @@ typedef struct {
     uint8_t y;
     uint8_t length;
     char *buffer;
+    bool dirty;                    // Text changed since it was last rendered
+    bool int_valid;                // buffer holds last_int (CHAR_CANVAS_update_int)
+    uint32_t last_int;
 } CHAR_CANVAS_obj_t;
 
 // A Page: A collection of UI Widgets and a static background
@@ -44,18 +59,40 @@ typedef struct {
 
 // The Master Canvas Controller
 typedef struct {
-    char *canvas_buffer;           // Working memory (40x2)
+    char *canvas_buffer;           // Working memory (40x2), full compositions only
     CHAR_DISPLAY_t *display;       // Link to the hardware buffer
     CHAR_Page_t pages[TOTAL_PAGES];
+    CHAR_CANVAS_Pages_e obj_page[MAX_OBJECTS]; // Page each object lives on
     CHAR_CANVAS_Pages_e current_page_idx;
-    bool has_updated;
+    bool has_updated;              // Some object is dirty
+    bool recompose;                // Rebuild the whole page (switch, refresh)
+    bool flush_pending;            // Display still converging (budgeted flush)
 } CHAR_CANVAS_t;
 
 /* Public API */
 void CHAR_CANVAS_ctor(CHAR_CANVAS_t * const me, CHAR_DISPLAY_t * display_driver);
 void CHAR_CANVAS_obj_init(CHAR_CANVAS_t * const me, CHAR_CANVAS_Pages_e page, CHAR_CANVAS_obj_e type, uint8_t x, uint8_t y, uint8_t len);
+/**
+ * @brief Set an object's text (space padded to its length)
+ * @note Marks the object dirty only if the text actually changed
+ */
 void CHAR_CANVAS_update_obj(CHAR_CANVAS_t * const me, CHAR_CANVAS_obj_e type, const char * str);
+
+/**
+ * @brief Show an unsigned integer right-aligned in an object, without
+ *        printf
+ * @note Values wider than the object show as all 9s. Repeating the value
+ *       last shown costs a compare.
+ */
+void CHAR_CANVAS_update_int(CHAR_CANVAS_t * const me, CHAR_CANVAS_obj_e type, uint32_t value);
 void CHAR_CANVAS_switch_page(CHAR_CANVAS_t * const me, CHAR_CANVAS_Pages_e page);
+/**
+ * @brief Bring the display buffer up to date and flush it to the LCD
+ * @note Only dirty objects are patched into the display buffer; the static
+ *       template is composed again after a page switch or with recompose
+ *       set. A flush is budgeted: call every frame while flush_pending is
+ *       set
+ */
 void CHAR_CANVAS_render(CHAR_CANVAS_t * const me);
 
 #endif /* INC_CHAR_CANVAS_H_ */
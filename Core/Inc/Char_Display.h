@@ -16,6 +16,25 @@
 // Set to 0 for full buffer updates (simpler but slower)
 #define CHAR_DISPLAY_USE_DIRTY_TRACKING 1
 
+// Flush cost model, in I2C transactions (PCF8574 writes, ~200 us each) per
+// LCD action. The span planner bridges a gap of unchanged cells by
+// rewriting it when that costs no more than a cursor move
+#define CHAR_DISPLAY_COST_CHAR 1
+#define CHAR_DISPLAY_COST_MOVE 1
+
+// Budgeted flush (dirty tracking only): each CHAR_DISPLAY_buffer_flush()
+// spends at most this many I2C transactions and waits for the previous
+// slice to drain first, so a page switch converges over a few frames
+// instead of stalling one. Higher priority cells go first
+// (CHAR_DISPLAY_set_priority)
+#define CHAR_DISPLAY_FLUSH_BUDGET 24
+#define CHAR_DISPLAY_PRIO_LEVELS 2
+
+typedef enum {
+	CHAR_DISPLAY_PRIO_LOW = 0,         // Static text
+	CHAR_DISPLAY_PRIO_HIGH             // Widgets (live values)
+} CHAR_DISPLAY_prio_e;
+
 typedef struct{
 	char * buffer;
 	SPLC780D_t * driver;
@@ -24,6 +43,15 @@ typedef struct{
 	char * shadow_buffer;      // Previous state for comparison
 	bool * dirty_flags;        // Per-character dirty flags
 	bool full_refresh_needed;  // Force complete redraw
+	uint8_t priority[CHAR_DISP_COLS * CHAR_DISP_ROWS]; // CHAR_DISPLAY_prio_e per cell
+	int16_t hw_cursor;         // LCD address counter as a buffer index, -1 unknown
+
+	// Flush statistics (since the last CHAR_DISPLAY_report())
+	uint16_t update_cost;      // Transactions of the update still converging
+	uint16_t cost_max;
+	uint32_t cost_sum;
+	uint32_t updates;          // Flushes that converged
+	uint32_t bridged;          // Unchanged cells rewritten to save a move
 #endif
 } CHAR_DISPLAY_t;
 
@@ -32,10 +60,55 @@ void CHAR_DISPLAY_clear(CHAR_DISPLAY_t * const me, SPLC780D_t * display_driver);
 
 void CHAR_WRITE_data(CHAR_DISPLAY_t * const me, char * const str, uint8_t x, uint8_t y);
 
-void CHAR_DISPLAY_buffer_flush(CHAR_DISPLAY_t * const me);
+/**
+ * @brief Load a custom character (see SPLC780D_define_glyph)
+ * @param me Pointer to display instance
+ * @param index Glyph 0-7, shown by buffer cells holding 0x08 + index
+ * @param rows 8 row patterns, top first
+ */
+void CHAR_DISPLAY_define_glyph(CHAR_DISPLAY_t * const me, uint8_t index, const uint8_t rows[8]);
+
+/**
+ * @brief Replace the whole buffer (CHAR_DISP_COLS * CHAR_DISP_ROWS cells,
+ *        no terminator) and mark the cells that differ from the LCD
+ * @param me Pointer to display instance
+ * @param cells New contents
+ */
+void CHAR_DISPLAY_load(CHAR_DISPLAY_t * const me, const char * cells);
+
+/**
+ * @brief Send the buffer to the LCD
+ * @param me Pointer to display instance
+ * @return true once the LCD has been handed everything; false if the
+ *         budget ran out (call again next frame to resume)
+ */
+bool CHAR_DISPLAY_buffer_flush(CHAR_DISPLAY_t * const me);
 
 #if CHAR_DISPLAY_USE_DIRTY_TRACKING
 void CHAR_DISPLAY_force_refresh(CHAR_DISPLAY_t * const me);
+
+/**
+ * @brief Set the flush priority of a run of cells (clipped to the row)
+ * @param me Pointer to display instance
+ * @param x, y First cell
+ * @param len Number of cells
+ * @param level CHAR_DISPLAY_prio_e
+ */
+void CHAR_DISPLAY_set_priority(CHAR_DISPLAY_t * const me, uint8_t x, uint8_t y,
+		uint8_t len, CHAR_DISPLAY_prio_e level);
+
+/**
+ * @brief Every cell back to CHAR_DISPLAY_PRIO_LOW
+ * @param me Pointer to display instance
+ */
+void CHAR_DISPLAY_reset_priority(CHAR_DISPLAY_t * const me);
+
+/**
+ * @brief Log I2C transactions per converged update over UART, then reset
+ *        (silent without updates)
+ * @param me Pointer to display instance
+ */
+void CHAR_DISPLAY_report(CHAR_DISPLAY_t * const me);
 #endif
 
 #endif /* INC_CHAR_DISPLAY_H_ */
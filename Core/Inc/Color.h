@@ -0,0 +1,68 @@
+/*
+ * Color.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_COLOR_H_
+#define INC_COLOR_H_
+
+#include <stdint.h>
+#include "pixel.h"
+
+#define COLOR_HUE_STEPS 256   // Hue wheel resolution (one full turn)
+#define COLOR_FOOD_LUT_SIZE 20
+
+/*
+ * Integer-only hue -> RGB at full saturation/value.
+ * Usable in constant expressions, so tables built from it live in flash.
+ * The wheel is split into 6 sectors of 256 steps each.
+ */
+#define COLOR_HUE_POS(h)    (((uint32_t) (h) * 6U) % (COLOR_HUE_STEPS * 6U))
+#define COLOR_HUE_SECTOR(h) (COLOR_HUE_POS(h) / COLOR_HUE_STEPS)
+#define COLOR_HUE_RISE(h)   (COLOR_HUE_POS(h) % COLOR_HUE_STEPS)
+#define COLOR_HUE_FALL(h)   (255U - COLOR_HUE_RISE(h))
+
+#define COLOR_HUE_RED(h)   ((COLOR_HUE_SECTOR(h) == 0 || COLOR_HUE_SECTOR(h) == 5) ? 255U : \
+                            (COLOR_HUE_SECTOR(h) == 1) ? COLOR_HUE_FALL(h) : \
+                            (COLOR_HUE_SECTOR(h) == 4) ? COLOR_HUE_RISE(h) : 0U)
+#define COLOR_HUE_GREEN(h) ((COLOR_HUE_SECTOR(h) == 1 || COLOR_HUE_SECTOR(h) == 2) ? 255U : \
+                            (COLOR_HUE_SECTOR(h) == 0) ? COLOR_HUE_RISE(h) : \
+                            (COLOR_HUE_SECTOR(h) == 3) ? COLOR_HUE_FALL(h) : 0U)
+#define COLOR_HUE_BLUE(h)  ((COLOR_HUE_SECTOR(h) == 3 || COLOR_HUE_SECTOR(h) == 4) ? 255U : \
+                            (COLOR_HUE_SECTOR(h) == 2) ? COLOR_HUE_RISE(h) : \
+                            (COLOR_HUE_SECTOR(h) == 5) ? COLOR_HUE_FALL(h) : 0U)
+
+// Full-saturation rainbow, COLOR_HUE_STEPS entries (const, in flash)
+extern const PIXEL_t COLOR_HUE_WHEEL[COLOR_HUE_STEPS];
+
+// Food "breathing" fade from white to dim grey (const, in flash)
+extern const PIXEL_t COLOR_FOOD_LUT[COLOR_FOOD_LUT_SIZE];
+
+/**
+ * @brief Convert HSV to RGB with integer math only
+ * @param hue 0-255 position on the color wheel
+ * @param sat 0-255 saturation (0 = white)
+ * @param val 0-255 value/brightness (0 = off)
+ * @return Converted color
+ * @note Matches COLOR_HUE_WHEEL at sat = val = 255
+ */
+PIXEL_t COLOR_hsv_to_rgb(uint8_t hue, uint8_t sat, uint8_t val);
+
+/**
+ * @brief Scale a color by level/255 with integer math only
+ * @param color Color to scale
+ * @param level 0 = off, 255 = unchanged
+ * @return Scaled color
+ */
+static inline PIXEL_t COLOR_scale(PIXEL_t color, uint8_t level) {
+	uint16_t factor = (uint16_t) level + 1; // 255 -> 256 keeps full color exact
+
+	for (int i = 0; i < PIXEL_SIZE; i++) {
+		color.pixel_array[i] = (uint8_t) ((color.pixel_array[i] * factor) >> 8);
+	}
+	return color;
+}
+
+#endif /* INC_COLOR_H_ */
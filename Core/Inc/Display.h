@@ -10,9 +10,10 @@
 
 #include "WS2812B.h"
 #include "pixel.h"
+#include "board_config.h"
 
-#define DISPLAY_ROWS (8 * 3) // TODO: Figure out Display stitching if to expand
-#define DISPLAY_COLS 8
+#define DISPLAY_ROWS BOARD_ROWS
+#define DISPLAY_COLS BOARD_COLS
 
 #define DEFAULT_BRIGHTNESS 1U << 3
 
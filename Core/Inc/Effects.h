@@ -0,0 +1,50 @@
+/*
+ * Effects.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_EFFECTS_H_
+#define INC_EFFECTS_H_
+
+#include "Game.h"
+
+// Phase value meaning "a full tick period has elapsed"
+#define EFFECTS_PHASE_FULL 255
+
+/**
+ * @brief Post-render effects stage
+ *
+ * Runs between GAME_render() and CANVAS_sync(). The snake moves at the
+ * tick rate (5-15 Hz) while frames are rendered at RENDER_RATE, so most
+ * frames would be identical. The effects stage blends between the previous
+ * and current tick using the sub-tick phase:
+ * - the new head fades in
+ * - the cell vacated by the tail fades out
+ *
+ * Only the cells that changed on the last tick are touched, so the cost
+ * is two pixels per snake per frame regardless of board size or length.
+ */
+typedef struct {
+	GAME_Engine_t *game;
+	CANVAS_t *canvas;
+} EFFECTS_t;
+
+/**
+ * @brief Initialize the effects stage
+ * @param me Pointer to EFFECTS instance
+ * @param game Pointer to initialized game engine (its canvas is used)
+ */
+void EFFECTS_ctor(EFFECTS_t *const me, GAME_Engine_t *game);
+
+/**
+ * @brief Blend the cells changed by the last tick into the canvas
+ * @param me Pointer to EFFECTS instance
+ * @param phase Sub-tick phase, 0 = tick just happened,
+ *              EFFECTS_PHASE_FULL = next tick is due
+ * @note Call after GAME_render() and before CANVAS_sync()
+ */
+void EFFECTS_apply(EFFECTS_t *const me, uint8_t phase);
+
+#endif /* INC_EFFECTS_H_ */
@@ -9,14 +9,47 @@
 #define INC_FPS_COUNTER_UTIL_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+
+// Frame pacing window: the last N frame times (~2 s at 60 FPS)
+#define FPS_WINDOW_FRAMES   128        // Power of 2
+
+// Frame time histogram: FPS_HIST_BUCKETS buckets of FPS_HIST_BUCKET_US,
+// the last one also takes every longer frame
+#define FPS_HIST_BUCKET_US  500
+#define FPS_HIST_BUCKETS    64         // 0..32 ms
+
+_Static_assert((FPS_WINDOW_FRAMES & (FPS_WINDOW_FRAMES - 1)) == 0,
+        "FPS_WINDOW_FRAMES must be a power of 2");
 
 typedef struct {
     uint32_t frame_count;       // Total frames rendered
-    uint32_t last_update_tick;  // Last time FPS was calculated
+    uint32_t last_update_tick;  // Last time FPS was calculated (us)
     uint32_t fps;               // Current FPS value
-    uint32_t update_interval;   // How often to recalculate (ms)
+    uint32_t update_interval;   // How often to recalculate (us)
+
+    // Frame pacing over the last FPS_WINDOW_FRAMES frames
+    uint32_t last_frame;                          // Start of the previous frame (us)
+    bool has_last_frame;
+    uint32_t frame_us[FPS_WINDOW_FRAMES];         // Ring of frame times
+    uint16_t head;                                // Next slot in frame_us
+    uint16_t samples;                             // Valid entries (<= window)
+    uint16_t hist[FPS_HIST_BUCKETS];              // Counts of the window's frames
+    uint64_t sum_us;                              // Of the window's frames
+    uint64_t sum_sq_us;                           // Of the window's frames, squared
 } FPS_Counter_t;
 
+// Frame pacing summary (all times in microseconds)
+typedef struct {
+    uint16_t frames;            // Frames in the window
+    uint32_t avg_us;
+    uint32_t p50_us;            // Percentiles: upper edge of the histogram bucket
+    uint32_t p95_us;
+    uint32_t p99_us;
+    uint32_t max_us;            // Exact
+    uint32_t jitter_us;         // Standard deviation of the frame time
+} FPS_Pacing_t;
+
 /**
  * @brief Initialize FPS counter
  * @param me Pointer to FPS counter instance
@@ -27,10 +60,11 @@ void FPS_ctor(FPS_Counter_t *me, uint32_t update_interval_ms);
 /**
  * @brief Call this once per frame render
  * @param me Pointer to FPS counter instance
- * @param current_tick Current HAL_GetTick() value
+ * @param now_us Current time in microseconds (SCHED_now_us(), wraps safely)
  * @return Current FPS value (updated every update_interval_ms)
+ * @note Also records the time since the previous call in the pacing window
  */
-uint32_t FPS_tick(FPS_Counter_t *me, uint32_t current_tick);
+uint32_t FPS_tick(FPS_Counter_t *me, uint32_t now_us);
 
 /**
  * @brief Get current FPS without updating
@@ -39,6 +73,19 @@ uint32_t FPS_tick(FPS_Counter_t *me, uint32_t current_tick);
  */
 uint32_t FPS_get(FPS_Counter_t *me);
 
+/**
+ * @brief Compute frame-time percentiles, max and jitter over the window
+ * @param me Pointer to FPS counter instance
+ * @param out Filled in (all zero before the second frame)
+ */
+void FPS_get_pacing(const FPS_Counter_t *me, FPS_Pacing_t *out);
+
+/**
+ * @brief Log the pacing summary and the non-empty histogram buckets over UART
+ * @param me Pointer to FPS counter instance
+ */
+void FPS_report(const FPS_Counter_t *me);
+
 /**
  * @brief Reset the counter
  * @param me Pointer to FPS counter instance
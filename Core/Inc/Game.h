@@ -11,7 +11,7 @@
 #include "Canvas.h"
 #include "Input.h"  // Only for key_action_e enum type
 
-#define REFRESH_RATE 60
+// Task rates in Hz (exact, any value: see Scheduler.h)
 #define INPUT_RATE 30
 #define RENDER_RATE 60
 
@@ -19,18 +19,49 @@
 // AI mode: 15 Hz (fast)
 // Manual mode: 5 Hz (slower for human)
 
-#define MAX_SNAKE_LEN (DISPLAY_COLS * DISPLAY_ROWS)
+#define MAX_SNAKE_LEN CELL_COUNT
+
+// Multi-snake mode: up to GAME_MAX_SNAKES snakes share the board,
+// the active count is chosen at runtime (1 = classic single snake)
+#ifndef GAME_MAX_SNAKES
+#define GAME_MAX_SNAKES 4
+#endif
+
+#define GAME_FOOD_POOL GAME_MAX_SNAKES   // One active food per snake
+
+_Static_assert(GAME_MAX_SNAKES >= 1 && GAME_MAX_SNAKES <= 8, "GAME_MAX_SNAKES out of range");
+
+/**
+ * @brief One snake on the shared board
+ *
+ * The body is a ring buffer so a move only writes the new head slot:
+ * segment i (0 = head) lives at body[(head + i) % MAX_SNAKE_LEN],
+ * see SNAKE_segment().
+ */
+typedef struct {
+	CELL_t body[MAX_SNAKE_LEN];          // Ring buffer of packed cell ids
+	CELL_INDEX_t head;                   // Ring slot holding the head
+	CELL_INDEX_t length;
+	key_action_e current_dir;
+
+	// Motion state of the last tick (read by the effects stage)
+	CELL_t vacated;              // Cell the tail left on the last move
+	bool has_moved;              // Last tick actually moved this snake
+} SNAKE_t;
 
 typedef struct {
 	CANVAS_t * canvas;
 
 	// --- Snake State ---
-	C_COORDINATES_t body[MAX_SNAKE_LEN];
-	uint8_t length;
-	key_action_e current_dir;
+	SNAKE_t snakes[GAME_MAX_SNAKES];
+	uint8_t num_snakes;                  // Active snakes (1..GAME_MAX_SNAKES)
+
+	// Shared occupancy of all snakes: body segments on each cell
+	uint8_t occupancy[CELL_COUNT];
+	CELL_INDEX_t occupied_cells;         // Cells with occupancy > 0
 
-	// Food State
-	C_COORDINATES_t food;
+	// Food State (food[0..num_snakes-1] are active)
+	CELL_t food[GAME_FOOD_POOL];
 	uint8_t food_color;
 
 	// Game statistics (exposed for UI to read)
@@ -43,8 +74,31 @@ typedef struct {
 
 	// Dynamic tick rate (5 for manual, 15 for AI)
 	uint8_t level_tick_rate;
+
+	bool has_moved;              // Any snake moved on the last tick
 }GAME_Engine_t;
 
+/**
+ * @brief Get body segment of a snake
+ * @param snake Pointer to snake
+ * @param index Segment index (0 = head, length - 1 = tail)
+ * @return Cell id of the segment
+ */
+static inline CELL_t SNAKE_segment(const SNAKE_t *snake, CELL_INDEX_t index) {
+	uint32_t slot = (uint32_t) snake->head + index;
+	if (slot >= MAX_SNAKE_LEN)
+		slot -= MAX_SNAKE_LEN;
+	return snake->body[slot];
+}
+
+static inline CELL_t SNAKE_head(const SNAKE_t *snake) {
+	return snake->body[snake->head];
+}
+
+static inline CELL_t SNAKE_tail(const SNAKE_t *snake) {
+	return SNAKE_segment(snake, snake->length - 1);
+}
+
 /**
  * @brief Initialize the game engine
  * @param me Pointer to GAME_Engine instance
@@ -59,13 +113,27 @@ void GAME_ctor(GAME_Engine_t * const me, CANVAS_t * canvas);
  * @param new_action Input action to process (directional movement)
  * @note This only updates direction, doesn't move the snake
  *       Call GAME_tick() to actually advance the game state
+ *       Controls snake 0, see GAME_update_snake() for the others
  */
 void GAME_update(GAME_Engine_t *const me, key_action_e const new_action);
 
 /**
- * @brief Advance game state by one tick (move snake, check collisions)
+ * @brief Update direction of one snake based on input action
+ * @param me Pointer to GAME_Engine instance
+ * @param snake_id Snake to steer (0..num_snakes-1)
+ * @param new_action Input action to process (directional movement)
+ * @return true if the direction changed (false for a 180-degree turn, the
+ *         current direction or a non-directional action)
+ */
+bool GAME_update_snake(GAME_Engine_t *const me, uint8_t snake_id,
+		key_action_e const new_action);
+
+/**
+ * @brief Advance game state by one tick (move snakes, check collisions)
  * @param me Pointer to GAME_Engine instance
  * @note Should be called at level_tick_rate (5-15 Hz depending on mode)
+ *       Cost is O(1) per snake plus the cells that changed, not the
+ *       total body length
  */
 void GAME_tick(GAME_Engine_t * const me);
 
@@ -83,4 +151,29 @@ void GAME_render(GAME_Engine_t * const me);
  */
 void GAME_reset(GAME_Engine_t *const me);
 
+/**
+ * @brief Change the number of active snakes and restart the game
+ * @param me Pointer to GAME_Engine instance
+ * @param num_snakes Requested count, clamped to 1..GAME_MAX_SNAKES
+ */
+void GAME_set_num_snakes(GAME_Engine_t *const me, uint8_t num_snakes);
+
+/**
+ * @brief Check whether an active food item sits on a cell
+ * @param me Pointer to GAME_Engine instance
+ * @param cell Cell id to test
+ * @return true if any active food is on the cell
+ */
+bool GAME_is_food(const GAME_Engine_t *const me, CELL_t cell);
+
+/**
+ * @brief Get the rainbow color of a body segment
+ * @param me Pointer to GAME_Engine instance
+ * @param snake_id Snake the segment belongs to (shifts the rainbow hue)
+ * @param index Segment index (0 = head)
+ * @return Color the segment is drawn with by GAME_render()
+ */
+PIXEL_t GAME_get_segment_color(GAME_Engine_t *const me, uint8_t snake_id,
+		CELL_INDEX_t index);
+
 #endif /* INC_GAME_H_ */
@@ -0,0 +1,235 @@
+/*
+ * I2C_Bus.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_I2C_BUS_H_
+#define INC_I2C_BUS_H_
+
+#include "main.h"
+#include <stdbool.h>
+
+/**
+ * Interrupt-driven I2C transaction queue
+ *
+ * All devices on one I2C peripheral (keypad and LCD expanders on hi2c1)
+ * submit transactions here instead of calling the blocking HAL functions.
+ * The queue starts them one at a time with HAL_I2C_Master_*_IT() and calls
+ * each transaction's completion callback from the I2C interrupt, where the
+ * next one is started. Blocking callers use I2C_BUS_transfer(), which
+ * queues behind whatever is pending and waits for its own result.
+ *
+ * The I2Cx_EV/ER_IRQHandlers call the HAL handlers as usual; this module
+ * implements the HAL master completion and error callbacks.
+ *
+ * PCF8574 transfers are a single byte, so interrupts are used rather than
+ * DMA: the stream setup would cost more than the transfer.
+ *
+ * Device health
+ *
+ * Every address seen on the bus gets a health entry. After
+ * I2C_BUS_FAIL_THRESHOLD failures in a row the device is marked down and
+ * its transactions fail at submit without touching the bus. Once per
+ * backoff period (doubling up to I2C_BUS_BACKOFF_MAX_MS) one transaction
+ * is let through as a probe; the first success brings the device back.
+ * A bus stuck low (slave holding SDA mid-byte) is freed by clocking SCL
+ * by hand before the peripheral is re-initialized. Asynchronous
+ * transactions have no caller waiting on them, so I2C_BUS_poll() resets
+ * the bus when one stays on it longer than I2C_BUS_TIMEOUT_MS.
+ *
+ * Boot discovery
+ *
+ * I2C_BUS_discover() probes every address once with a short timeout and
+ * keeps the map of responding devices for the driver constructors. The map
+ * is cached in RTC backup registers, which survive a reset but not a power
+ * cycle, so warm boots skip the probe. Drivers that miss their device in
+ * a cached map re-run the probe, so a stale cache costs one probe.
+ */
+
+#define I2C_BUS_QUEUE_SIZE   16        // Pending transactions, power of 2
+#define I2C_BUS_MAX_LEN      4         // Bytes per write (copied on submit)
+#define I2C_BUS_TIMEOUT_MS   100       // Transfers (blocking or not), then bus reset
+#define I2C_BUS_IRQ_SUBPRIO  2         // Group 0: orders pending IRQs, never preempts
+
+#define I2C_BUS_MAX_DEVICES      4     // Health entries per bus
+#define I2C_BUS_FAIL_THRESHOLD   3     // Failures in a row to mark a device down
+#define I2C_BUS_BACKOFF_MIN_MS   50    // First retry after going down
+#define I2C_BUS_BACKOFF_MAX_MS   2000
+
+#define I2C_BUS_PROBE_FIRST      0x08  // Skip reserved addresses
+#define I2C_BUS_PROBE_LAST       0x77
+#define I2C_BUS_PROBE_TIMEOUT_MS 2     // Per address (a NACK takes ~100 us)
+#define I2C_BUS_MAP_WORDS        4     // 128 address bits
+#define I2C_BUS_MAP_MAGIC        0x12C0CAFEU
+
+_Static_assert((I2C_BUS_QUEUE_SIZE & (I2C_BUS_QUEUE_SIZE - 1)) == 0,
+		"I2C_BUS_QUEUE_SIZE must be a power of 2");
+
+typedef enum {
+	I2C_BUS_WRITE,
+	I2C_BUS_READ
+} I2C_BUS_dir_e;
+
+/**
+ * @brief Completion callback, called from the I2C interrupt (or from the
+ *        submitting context when the transfer can't be started)
+ * @param ctx Context given at submit
+ * @param status HAL_OK, or the error that ended the transfer
+ * @note May submit further transactions
+ */
+typedef void (*I2C_BUS_done_fn)(void *ctx, HAL_StatusTypeDef status);
+
+typedef struct {
+	uint8_t address;                   // 7-bit device address
+	bool down;                         // Fast-failing until retry_at
+	bool probing;                      // Retry transaction on the bus
+	uint8_t consecutive_failures;
+	uint32_t failures;                 // Since boot
+	uint32_t report_failures;          // Since the last I2C_BUS_report()
+	uint32_t backoff_ms;
+	uint32_t retry_at;                 // HAL_GetTick() of the next probe
+} I2C_BUS_Device_t;
+
+typedef struct {
+	uint8_t address;                   // 7-bit device address
+	uint8_t dir;                       // I2C_BUS_dir_e
+	uint8_t len;
+	uint8_t tx[I2C_BUS_MAX_LEN];       // Write data (owned by the queue)
+	uint8_t *rx;                       // Read destination (caller owned)
+	I2C_BUS_Device_t *device;          // Health entry (NULL if the table is full)
+	I2C_BUS_done_fn done;              // May be NULL
+	void *ctx;
+} I2C_BUS_Transaction_t;
+
+typedef struct {
+	I2C_HandleTypeDef *hi2c;
+	I2C_BUS_Transaction_t queue[I2C_BUS_QUEUE_SIZE];
+	volatile uint16_t head;            // Oldest pending (active while busy)
+	volatile uint16_t tail;            // Next free slot
+	volatile bool busy;                // Transaction at head is on the bus
+	uint32_t started_us;               // SCHED_now_us() when head was started
+	volatile uint32_t busy_us;         // Time on the bus, free running
+
+	I2C_BUS_Device_t devices[I2C_BUS_MAX_DEVICES];
+	uint8_t num_devices;
+
+	// Boot discovery (I2C_BUS_discover)
+	uint32_t present[I2C_BUS_MAP_WORDS]; // Bit per 7-bit address
+	bool map_valid;
+	bool map_cached;                   // Loaded from backup registers
+
+	// Statistics (since the last I2C_BUS_report())
+	uint32_t completed;
+	uint32_t errors;
+	uint32_t rejected;                 // Submits refused, queue full
+	uint32_t fast_failed;              // Submits refused, device down
+	uint32_t recoveries;               // Bus re-initializations
+	uint16_t max_depth;
+} I2C_BUS_t;
+
+/**
+ * @brief Take over an initialized I2C handle and enable its interrupts
+ * @param me Pointer to bus instance (one per I2C peripheral)
+ * @param hi2c Initialized HAL handle (MX_I2Cx_Init)
+ */
+void I2C_BUS_ctor(I2C_BUS_t *const me, I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief Build the map of responding addresses (blocking, before any
+ *        transactions are queued)
+ * @param me Pointer to bus instance
+ * @param use_cache Take the map from the backup registers if it is there;
+ *                  false forces a probe (and refreshes the cache)
+ * @return Milliseconds spent probing (0 when the cache was used)
+ * @note A probe takes ~15 ms with the bus healthy. A stuck bus is
+ *       recovered once, then the probe gives up.
+ */
+uint32_t I2C_BUS_discover(I2C_BUS_t *const me, bool use_cache);
+
+/**
+ * @brief Did address answer during discovery?
+ * @param me Pointer to bus instance
+ * @param address 7-bit device address
+ * @return true if no discovery ran (assume present)
+ */
+bool I2C_BUS_present(const I2C_BUS_t *const me, uint8_t address);
+
+/**
+ * @brief Queue a transaction without waiting for it
+ * @param me Pointer to bus instance
+ * @param address 7-bit device address
+ * @param dir I2C_BUS_WRITE (data is copied) or I2C_BUS_READ (data is the
+ *            destination and must stay valid until done is called)
+ * @param data Bytes to write or read buffer
+ * @param len 1..I2C_BUS_MAX_LEN for writes
+ * @param done Completion callback (may be NULL)
+ * @param ctx Passed to done
+ * @return false if the queue is full, the device is down (backing off) or
+ *         len is invalid (done is not called)
+ * @note Safe from interrupt context and from completion callbacks
+ */
+bool I2C_BUS_submit(I2C_BUS_t *const me, uint8_t address, I2C_BUS_dir_e dir,
+		uint8_t *data, uint8_t len, I2C_BUS_done_fn done, void *ctx);
+
+/**
+ * @brief Queue a transaction and wait for it (task context only)
+ * @param me Pointer to bus instance
+ * @param address 7-bit device address
+ * @param dir Transfer direction
+ * @param data Bytes to write or read buffer
+ * @param len Transfer length
+ * @return Transfer status; HAL_ERROR at once while the device is down,
+ *         HAL_TIMEOUT after I2C_BUS_TIMEOUT_MS, in which case the bus is
+ *         recovered and the queue flushed
+ */
+HAL_StatusTypeDef I2C_BUS_transfer(I2C_BUS_t *const me, uint8_t address,
+		I2C_BUS_dir_e dir, uint8_t *data, uint8_t len);
+
+/**
+ * @brief Watchdog: reset the bus if the transaction on it has not
+ *        completed within I2C_BUS_TIMEOUT_MS (call periodically, e.g. from
+ *        the report task)
+ * @param me Pointer to bus instance
+ * @note Everything queued then completes with HAL_TIMEOUT, so drivers
+ *       waiting on a callback (keypad scan, LCD pipeline) carry on
+ */
+void I2C_BUS_poll(I2C_BUS_t *const me);
+
+/**
+ * @brief Nothing queued or on the bus
+ * @param me Pointer to bus instance
+ */
+bool I2C_BUS_idle(const I2C_BUS_t *const me);
+
+/**
+ * @brief Health entry of a device
+ * @param me Pointer to bus instance
+ * @param address 7-bit device address
+ * @return NULL if nothing was ever sent to address
+ */
+const I2C_BUS_Device_t* I2C_BUS_device(const I2C_BUS_t *const me,
+		uint8_t address);
+
+/**
+ * @brief Failed transactions since boot, all devices (e.g. for the UI)
+ * @param me Pointer to bus instance
+ */
+uint32_t I2C_BUS_failures(const I2C_BUS_t *const me);
+
+/**
+ * @brief Time transactions have spent on the bus (us, wraps); the
+ *        difference over an interval gives the bus load
+ * @param me Pointer to bus instance
+ */
+uint32_t I2C_BUS_busy_us(const I2C_BUS_t *const me);
+
+/**
+ * @brief Log transaction counts and unhealthy devices over UART, then reset
+ *        the counts
+ * @param me Pointer to bus instance
+ */
+void I2C_BUS_report(I2C_BUS_t *const me);
+
+#endif /* INC_I2C_BUS_H_ */
@@ -16,16 +16,94 @@ typedef enum {
     ACTION_LEFT,
     ACTION_RIGHT,
     ACTION_CONFIRM,
+    ACTION_HUD,        // Settings: leave with the performance HUD shown
     ACTION_NONE
 } key_action_e;
 
+/**
+ * Input event queue
+ *
+ * Every press and release seen by INPUT_get_action() is also queued with
+ * its SCHED_now_us() timestamp. The input task produces at INPUT_RATE and
+ * the game tick consumes, so presses that land between two ticks are kept
+ * in order instead of overwriting each other. Single producer, single
+ * consumer: head is only written by the consumer, tail by the producer,
+ * so neither side needs to mask interrupts.
+ */
+#define INPUT_QUEUE_SIZE 16                // Power of 2
+
+_Static_assert((INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) == 0,
+        "INPUT_QUEUE_SIZE must be a power of 2");
+
+typedef enum {
+    INPUT_EVENT_PRESS = 0,
+    INPUT_EVENT_RELEASE
+} INPUT_event_type_e;
+
+typedef struct {
+    uint32_t timestamp_us;                 // SCHED_now_us() when seen
+    uint8_t type;                          // INPUT_event_type_e
+    uint8_t action;                        // key_action_e
+    uint8_t key;                           // keys_e
+} INPUT_Event_t;
+
+typedef struct {
+    INPUT_Event_t events[INPUT_QUEUE_SIZE];
+    volatile uint8_t head;                 // Next to pop (consumer)
+    volatile uint8_t tail;                 // Next free slot (producer)
+    uint32_t dropped;                      // Pushes refused, queue full
+} INPUT_Queue_t;
+
 typedef struct {
     KEYPAD_t * keypad;
     keys_e last_raw_key;
     bool key_processed;
+
+    INPUT_Queue_t queue;
+
+    // Input-to-move latency (since the last INPUT_report())
+    uint32_t latency_sum_us;
+    uint32_t latency_max_us;
+    uint16_t latency_count;
 } INPUT_t;
 
 void INPUT_ctor(INPUT_t * const me , KEYPAD_t * const keypad);
+
+/**
+ * @brief Turn the keypad state into one action per press
+ * @param me Pointer to input instance
+ * @return Action of a new press, else ACTION_NONE
+ * @note Also queues press/release events (producer side)
+ */
 key_action_e INPUT_get_action(INPUT_t *const me);
 
+/**
+ * @brief Take the oldest queued event (consumer side)
+ * @param me Pointer to input instance
+ * @param event Filled in when an event was queued
+ * @return false if the queue is empty
+ */
+bool INPUT_pop_event(INPUT_t *const me, INPUT_Event_t *event);
+
+/**
+ * @brief Drop all queued events (consumer side), e.g. while no one
+ *        consumes them
+ * @param me Pointer to input instance
+ */
+void INPUT_flush_events(INPUT_t *const me);
+
+/**
+ * @brief Record that a queued press took effect now
+ * @param me Pointer to input instance
+ * @param event The press, as popped
+ */
+void INPUT_record_latency(INPUT_t *const me, const INPUT_Event_t *event);
+
+/**
+ * @brief Log input-to-move latency and dropped events over UART, then
+ *        reset them (silent when there was no input)
+ * @param me Pointer to input instance
+ */
+void INPUT_report(INPUT_t *const me);
+
 #endif /* INC_INPUT_H_ */
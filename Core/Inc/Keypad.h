@@ -11,6 +11,32 @@
 #include <stdbool.h>
 #include "PCF8574.h"
 
+/**
+ * Interrupt-driven scanning
+ *
+ * Between scans all rows are driven low, so any key press or release
+ * changes a column input and the PCF8574 pulls its open-drain INT line
+ * low until the port is read. With INT wired to KEYPAD_INT_Pin,
+ * KEYPAD_poll() only scans after an edge and leaves the bus idle
+ * otherwise. The INT wire is an optional mod, so the default build scans
+ * on every poll; build with KEYPAD_USE_INT=1 once INT reaches PA8.
+ *
+ * Until the first edge confirms the wire, INT mode still scans every
+ * KEYPAD_INT_CHECK_POLLS polls. A key change found by such a check scan
+ * with no edge behind it means INT is not connected: the keypad falls
+ * back to scanning on every poll.
+ */
+#ifndef KEYPAD_USE_INT
+#define KEYPAD_USE_INT 0
+#endif
+
+#define KEYPAD_INT_CHECK_POLLS   16
+
+#define KEYPAD_INT_Pin           GPIO_PIN_8     // PA8 (Arduino D7) <- PCF8574 INT
+#define KEYPAD_INT_GPIO_Port     GPIOA
+#define KEYPAD_INT_EXTI_IRQn     EXTI9_5_IRQn
+#define KEYPAD_INT_IRQ_SUBPRIO   2              // Group 0: orders pending IRQs, never preempts
+
 typedef enum {
 	S1 = 0,
 	S2 = 1,
@@ -31,13 +57,57 @@ typedef enum {
 	NO_KEY
 }keys_e;
 
+typedef void (*KEYPAD_notify_fn)(void *ctx);
+
 typedef struct{
 	bool new_key_press;
 	keys_e key;
 	PCF8574_t driver;
+
+	// Interrupt mode (KEYPAD_enable_irq)
+	bool irq_enabled;
+	volatile bool irq_pending;         // INT edge outside a scan, or rescan needed
+	volatile bool irq_seen;            // An edge arrived: INT is wired
+	bool check_scan;                   // Scan in flight is an unprompted check
+	uint8_t idle_polls;                // Polls since the last scan, until irq_seen
+	KEYPAD_notify_fn notify;           // Work for KEYPAD_poll() (interrupt context)
+	void *notify_ctx;
+
+	// Asynchronous scan, advanced by I2C completion callbacks
+	volatile uint8_t scan_step;        // 0 = no scan on the bus
+	volatile bool scan_error;
+	volatile bool scan_done;           // scan_result ready for KEYPAD_poll()
+	keys_e scan_result;
 }KEYPAD_t;
 
-void KEYPAD_ctor(KEYPAD_t * const me, I2C_HandleTypeDef *i2cHandle);
+void KEYPAD_ctor(KEYPAD_t * const me, I2C_BUS_t *bus);
+
+/**
+ * @brief Apply the last finished scan to key / new_key_press and start
+ *        the next one
+ * @param me Pointer to keypad instance
+ * @note Never waits on the bus: a scan runs from I2C interrupts and its
+ *       result is picked up by the next call (the notify callback says
+ *       when). In interrupt mode no scan starts unless INT signalled a
+ *       change since the last one.
+ */
 void KEYPAD_poll(KEYPAD_t * const me);
 
+/**
+ * @brief Switch to interrupt-driven scanning on KEYPAD_INT_Pin
+ * @param me Pointer to keypad instance (one keypad per INT line)
+ * @param notify Called from interrupt context when KEYPAD_poll() has work:
+ *               an INT edge or a finished scan, e.g. to run the input task
+ *               early (may be NULL)
+ * @param ctx Passed to notify
+ * @note With KEYPAD_USE_INT=0 only the notify callback is set (scans are
+ *       started by every poll)
+ */
+void KEYPAD_enable_irq(KEYPAD_t * const me, KEYPAD_notify_fn notify, void *ctx);
+
+/**
+ * @brief INT line interrupt (call from EXTI9_5_IRQHandler)
+ */
+void KEYPAD_IRQHandler(void);
+
 #endif /* INC_KEYPAD_H_ */
@@ -0,0 +1,89 @@
+/*
+ * Latency.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_LATENCY_H_
+#define INC_LATENCY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Input-to-photon latency probe
+ *
+ * Follows one key press at a time from the keypad to the LED matrix
+ * (SCHED_now_us() timestamps) and splits its latency into:
+ *
+ *   poll   INT edge -> KEYPAD_poll() applies the scan that saw the press
+ *   tick   press -> GAME tick that turns the snake (manual play only)
+ *   render tick -> DISPLAY_update() of the first frame after it
+ *   wire   DISPLAY_update() start -> last LED bit sent
+ *
+ * Without the INT line (KEYPAD_USE_INT=0) the edge is the start of the
+ * scan that saw the press, so poll misses the wait for that scan (up to
+ * one input period). A press that never turns the snake (repeat, 180
+ * degrees, AI mode) is dropped when the next one comes in.
+ *
+ * Build with LATENCY_PROBE=1; by default all hooks compile away.
+ */
+#ifndef LATENCY_PROBE
+#define LATENCY_PROBE 0
+#endif
+
+#if LATENCY_PROBE
+
+typedef enum {
+	LAT_STAGE_POLL = 0,
+	LAT_STAGE_TICK,
+	LAT_STAGE_RENDER,
+	LAT_STAGE_WIRE,
+	LAT_NUM_STAGES
+} LAT_stage_e;
+
+/**
+ * @brief Key edge seen (INT interrupt, or start of a scan without INT)
+ */
+void LAT_edge(void);
+
+/**
+ * @brief KEYPAD_poll() applied a new press: start following it
+ */
+void LAT_press(void);
+
+/**
+ * @brief A game tick applied a queued press as a turn
+ * @param press_us Timestamp of the input event that was applied
+ */
+void LAT_turn(uint32_t press_us);
+
+/**
+ * @brief DISPLAY_update() is about to send a frame
+ */
+void LAT_frame_begin(void);
+
+/**
+ * @brief DISPLAY_update() sent the frame: completes a followed press
+ */
+void LAT_frame_end(void);
+
+/**
+ * @brief Log min/avg/max latency and the per-stage breakdown over UART,
+ *        then reset (silent without samples)
+ */
+void LAT_report(void);
+
+#else /* !LATENCY_PROBE */
+
+#define LAT_edge() ((void) 0)
+#define LAT_press() ((void) 0)
+#define LAT_turn(press_us) ((void) 0)
+#define LAT_frame_begin() ((void) 0)
+#define LAT_frame_end() ((void) 0)
+#define LAT_report() ((void) 0)
+
+#endif /* LATENCY_PROBE */
+
+#endif /* INC_LATENCY_H_ */
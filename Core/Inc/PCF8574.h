@@ -9,6 +9,7 @@
 #define INC_PCF8574_H_
 
 #include "main.h"
+#include "I2C_Bus.h"
 
 /*
  * DEFINES
@@ -51,16 +52,25 @@ typedef union port_config {
 } port_config_t;
 
 typedef struct {
-	I2C_HandleTypeDef *i2cHandle;
+	I2C_BUS_t *bus;
 	uint8_t address;
 	port_config_t set_pins;
 	port_config_t status_pins;
 } PCF8574_t;
 
 
-HAL_StatusTypeDef PCF8574_ctor(PCF8574_t * const dev, I2C_HandleTypeDef *i2cHandle);
+HAL_StatusTypeDef PCF8574_ctor(PCF8574_t * const dev, I2C_BUS_t *bus);
 
+/* Blocking: queue behind pending transfers and wait for the result */
 HAL_StatusTypeDef PCF8574_write(PCF8574_t * const dev);
 HAL_StatusTypeDef PCF8574_read(PCF8574_t * const dev);
 
+/*
+ * Non-blocking: write sends set_pins as it is now, read lands in
+ * status_pins. done runs from the I2C interrupt (may be NULL).
+ * Return false if the bus queue is full.
+ */
+bool PCF8574_write_async(PCF8574_t * const dev, I2C_BUS_done_fn done, void *ctx);
+bool PCF8574_read_async(PCF8574_t * const dev, I2C_BUS_done_fn done, void *ctx);
+
 #endif /* INC_PCF8574_H_ */
@@ -0,0 +1,119 @@
+/*
+ * Profiler.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_PROFILER_H_
+#define INC_PROFILER_H_
+
+#include <stdint.h>
+
+/**
+ * Per-stage cycle profiler on the DWT cycle counter (100 MHz = 10 ns/cycle)
+ *
+ * Wrap a stage in PROF_BEGIN()/PROF_END() within one scope:
+ *
+ *     PROF_BEGIN(PROF_GAME_TICK);
+ *     GAME_tick(me->game);
+ *     PROF_END(PROF_GAME_TICK);
+ *
+ * Each marker is one CYCCNT load; PROF_END adds a few ALU ops for
+ * min/max/sum and a CLZ for the log2 histogram bucket. PROF_report()
+ * dumps everything over UART and starts a new window.
+ *
+ * With TRACE_ENABLE the markers also record begin/end events in the
+ * trace ring (see Trace.h).
+ *
+ * Build with PROF_ENABLE=0 and all markers and calls compile away.
+ */
+#ifndef PROF_ENABLE
+#define PROF_ENABLE 1
+#endif
+
+// Profiled stages of the frame loop
+typedef enum {
+	PROF_KEYPAD_POLL,
+	PROF_PROCESS_INPUT,
+	PROF_ALGO,
+	PROF_GAME_TICK,
+	PROF_GAME_RENDER,
+	PROF_CANVAS_SYNC,
+	PROF_DISPLAY_UPDATE,
+	PROF_UI_REFRESH,
+	PROF_NUM_STAGES
+} PROF_stage_e;
+
+// Bucket b counts samples of 2^(b-1)..2^b - 1 cycles; the last bucket
+// also takes everything longer (2^23 cycles = 84 ms)
+#define PROF_HIST_BUCKETS 24
+
+#if PROF_ENABLE
+
+#include "main.h"
+#include "Trace.h"
+
+_Static_assert(PROF_NUM_STAGES <= TRACE_ID_TASK_BASE - TRACE_ID_STAGE_BASE,
+		"Profiler stages overflow their trace ids");
+
+typedef struct {
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+	uint16_t hist[PROF_HIST_BUCKETS];   // Saturating counts
+} PROF_Stage_t;
+
+extern PROF_Stage_t PROF_stages[PROF_NUM_STAGES];
+
+static inline uint32_t PROF_now(void) {
+	return DWT->CYCCNT;
+}
+
+static inline void PROF_record(PROF_stage_e stage, uint32_t cycles) {
+	PROF_Stage_t *s = &PROF_stages[stage];
+
+	s->count++;
+	s->sum += cycles;
+	if (cycles < s->min)
+		s->min = cycles;
+	if (cycles > s->max)
+		s->max = cycles;
+
+	uint32_t bucket = 32U - __CLZ(cycles);   // 0 for 0 cycles
+	if (bucket >= PROF_HIST_BUCKETS)
+		bucket = PROF_HIST_BUCKETS - 1;
+	if (s->hist[bucket] != UINT16_MAX)
+		s->hist[bucket]++;
+}
+
+#define PROF_BEGIN(stage) \
+	TRACE_BEGIN_EVENT(TRACE_ID_STAGE_BASE + (stage), 0); \
+	uint32_t prof_start_##stage = PROF_now()
+#define PROF_END(stage) \
+	PROF_record((stage), PROF_now() - prof_start_##stage); \
+	TRACE_END_EVENT(TRACE_ID_STAGE_BASE + (stage), 0)
+
+/**
+ * @brief Enable the DWT cycle counter, clear all stages and name them
+ * in the trace (call after TRACE_init())
+ */
+void PROF_init(void);
+
+/**
+ * @brief Log min/avg/max and the log2 histogram of every stage over UART,
+ * then clear them
+ */
+void PROF_report(void);
+
+#else /* !PROF_ENABLE */
+
+#define PROF_BEGIN(stage) ((void) 0)
+#define PROF_END(stage) ((void) 0)
+#define PROF_init() ((void) 0)
+#define PROF_report() ((void) 0)
+
+#endif /* PROF_ENABLE */
+
+#endif /* INC_PROFILER_H_ */
@@ -13,6 +13,44 @@
 #define CHAR_DISP_COLS 	40
 #define CHAR_DISP_ROWS	2
 
+/**
+ * Busy flag
+ *
+ * With SPLC780D_USE_BUSY_FLAG the driver reads DB7 back through the
+ * PCF8574 (RS low, RW high) instead of sleeping a fixed time after slow
+ * commands: clear and return home (1.52 ms) continue as soon as the
+ * controller is done. Short commands (37 us) are over before the next
+ * command's PCF8574 write has left the bus (~200 us at 100 kHz), so they
+ * are only checked with SPLC780D_POLL_EVERY_CMD, which sends every command
+ * blocking, bypassing the pipeline below (a debugging aid). If the flag
+ * never clears (RW not wired) the driver falls back to the fixed delays.
+ */
+#ifndef SPLC780D_USE_BUSY_FLAG
+#define SPLC780D_USE_BUSY_FLAG 1
+#endif
+
+#ifndef SPLC780D_POLL_EVERY_CMD
+#define SPLC780D_POLL_EVERY_CMD 0
+#endif
+
+#define SPLC780D_BUSY_MAX_POLLS 20     // ~4 ms of reads before giving up
+
+/**
+ * Command pipeline
+ *
+ * SPLC780D_move_cursor() and SPLC780D_write_char() only queue the command
+ * (RS bit + byte) and return. The pipeline sends the byte to the PCF8574
+ * with an asynchronous I2C write; its completion interrupt sets RS/RW,
+ * pulses E and starts the next byte. A full 80 character refresh is
+ * handed off in one go. The remaining (rare, slow) commands are sent
+ * blocking after the queue has drained.
+ */
+#define SPLC780D_QUEUE_SIZE     128    // Commands, power of 2 (full refresh: 82)
+#define SPLC780D_SYNC_TIMEOUT_MS 100   // Waiting for the queue, then it is dropped
+
+_Static_assert((SPLC780D_QUEUE_SIZE & (SPLC780D_QUEUE_SIZE - 1)) == 0,
+		"SPLC780D_QUEUE_SIZE must be a power of 2");
+
 typedef enum{
 	CURSOR_LEFT = 0,
 	CURSOR_RIGHT,
@@ -29,15 +67,57 @@ typedef struct{
 	uint16_t E_Pin;
 	PCF8574_t data_pins;
 	uint8_t cursor_x,cursor_y;
+	bool busy;              // Last command may still be executing
+	bool busy_flag_ok;      // Busy flag reads work (else fixed delays)
+
+	// Command pipeline, drained from the I2C completion interrupt
+	uint16_t queue[SPLC780D_QUEUE_SIZE];
+	volatile uint16_t q_head;      // Command on the bus / next to send
+	volatile uint16_t q_tail;      // Next free slot
+	volatile bool pipe_busy;       // A PCF8574 write is in flight
+	uint32_t dropped;              // Commands lost (LCD down, timeouts), see SPLC780D_report()
 }SPLC780D_t;
 
-void SPLC780D_ctor(SPLC780D_t * const me, I2C_HandleTypeDef *i2chandle);
+void SPLC780D_ctor(SPLC780D_t * const me, I2C_BUS_t *bus);
 void SPLC780D_Clear(SPLC780D_t *const me);
 
 void SPLC780D_reset_cursor(SPLC780D_t * const me);
 void SPLC780D_move_display_cursor(SPLC780D_t * const me,SPLC780D_CURSOR_MOVEMENT_e movement);
 
+/* Queued: return at once, see "Command pipeline" */
 void SPLC780D_move_cursor(SPLC780D_t * const me, uint8_t x, uint8_t y);
 void SPLC780D_write_char(SPLC780D_t * const me, const char data);
 
+#define SPLC780D_NUM_GLYPHS 8
+
+/**
+ * @brief Load a custom 5x8 character into CGRAM (queued)
+ * @param me Pointer to driver instance
+ * @param index Glyph 0-7; display it with character code 0x08 + index
+ *              (code index itself works too, but 0 is a string terminator)
+ * @param rows 8 row patterns, top first, bits 4-0 = columns left to right
+ * @note Leaves the address counter at the last move_cursor() position
+ */
+void SPLC780D_define_glyph(SPLC780D_t * const me, uint8_t index, const uint8_t rows[8]);
+
+/**
+ * @brief All queued commands have reached the LCD
+ * @param me Pointer to driver instance
+ */
+bool SPLC780D_idle(const SPLC780D_t * const me);
+
+/**
+ * @brief Log commands dropped since the last call over UART, then reset
+ *        (silent if none)
+ * @param me Pointer to driver instance
+ */
+void SPLC780D_report(SPLC780D_t * const me);
+
+/**
+ * @brief Wait until the queue has drained (drops it after
+ *        SPLC780D_SYNC_TIMEOUT_MS)
+ * @param me Pointer to driver instance
+ */
+void SPLC780D_sync(SPLC780D_t * const me);
+
 #endif /* INC_SPLC780D_H_ */
@@ -0,0 +1,172 @@
+/*
+ * Scheduler.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_SCHEDULER_H_
+#define INC_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SCHED_MAX_TASKS          8    // Trace ids TRACE_ID_TASK_BASE + 0..7
+#define SCHED_US_PER_S           1000000UL
+#define SCHED_LOAD_WINDOW_US     1000000UL   // CPU load averaging window
+
+typedef void (*SCHED_task_fn)(void *ctx);
+
+/**
+ * @brief One periodic task
+ *
+ * Releases happen at an exact rate: the period 1e6 / rate_hz is split into
+ * a whole number of microseconds plus a remainder that is accumulated, so
+ * rates that don't divide a second (7 Hz, 12 Hz...) don't drift.
+ *
+ * next_release works as a fixed-timestep accumulator: it only ever advances
+ * by whole periods, never to "now". When the task falls behind, up to
+ * max_catchup missed releases are replayed back-to-back (logic keeps exact
+ * speed); older ones are dropped and counted as skipped. With
+ * max_catchup = 0 a late task just runs once (render frames are skipped).
+ */
+typedef struct {
+	const char *name;
+	SCHED_task_fn run;
+	void *ctx;
+	uint8_t trace_id;            // Event id of this task in the trace
+
+	// Timing (microseconds)
+	uint32_t rate_hz;
+	uint32_t period_us;          // Whole part of 1e6 / rate_hz
+	uint32_t period_rem;         // Remainder of 1e6 / rate_hz
+	uint32_t rem_acc;            // Accumulated remainder (< rate_hz)
+	uint32_t deadline_us;        // Must finish this long after release
+	uint32_t last_release;       // Release time of the current/last job
+	uint32_t next_release;
+	uint8_t max_catchup;         // Missed releases replayed when late
+	bool stall_watch;            // A long run freezes the trace ring
+	volatile bool triggered;     // Released early by SCHED_trigger()
+
+	// Statistics (since the last SCHED_report())
+	uint32_t runs;
+	uint32_t deadline_misses;    // Finished after release + deadline_us
+	uint32_t overruns;           // Ran longer than its own period
+	uint32_t caught_up;          // Late releases replayed back-to-back
+	uint32_t skipped;            // Releases dropped (beyond max_catchup)
+	uint32_t triggers;           // Early runs from SCHED_trigger()
+	uint32_t latency_sum_us;     // Release -> start (jitter)
+	uint32_t latency_max_us;
+	uint32_t exec_max_us;        // Start -> finish
+} SCHED_Task_t;
+
+typedef struct {
+	SCHED_Task_t *tasks[SCHED_MAX_TASKS];
+	uint8_t num_tasks;
+
+	// Time spent asleep in WFI (since the last SCHED_report())
+	uint32_t idle_us;
+	uint32_t report_start;
+
+	// CPU load: WFI time in the current window, busy % of the last one
+	uint32_t load_idle_us;
+	uint32_t load_start;
+	uint8_t load_percent;
+} SCHED_t;
+
+/**
+ * @brief Initialize the scheduler and start its 1 MHz time base
+ * @param me Pointer to scheduler instance
+ */
+void SCHED_ctor(SCHED_t *const me);
+
+/**
+ * @brief Register a periodic task
+ * @param me Pointer to scheduler instance
+ * @param task Task storage (must outlive the scheduler)
+ * @param name Short name used in reports
+ * @param run Task body, called once per release
+ * @param ctx Passed to run()
+ * @param rate_hz Release rate in Hz (1..1000000)
+ * @param phase_us Offset of the first release from now, spreads tasks
+ *                 that share a rate so they don't all wake together
+ * @param deadline_us Relative deadline, 0 = one period
+ */
+void SCHED_add_task(SCHED_t *const me, SCHED_Task_t *task, const char *name,
+		SCHED_task_fn run, void *ctx, uint32_t rate_hz, uint32_t phase_us,
+		uint32_t deadline_us);
+
+/**
+ * @brief Change the rate of a task
+ * @param task Pointer to task
+ * @param rate_hz New rate in Hz
+ * @note The next release is re-timed from the last one at the new period,
+ *       so e.g. switching 5 Hz -> 15 Hz takes effect immediately
+ */
+void SCHED_set_rate(SCHED_Task_t *const task, uint32_t rate_hz);
+
+/**
+ * @brief Set how many missed releases a late task replays
+ * @param task Pointer to task
+ * @param max_catchup 0 = skip missed releases (default, for render-like
+ *                    tasks), N = replay up to N of them back-to-back
+ *                    (for game logic that must keep exact speed)
+ */
+void SCHED_set_catchup(SCHED_Task_t *const task, uint8_t max_catchup);
+
+/**
+ * @brief Choose whether a long run of this task counts as a stall
+ * @param task Pointer to task
+ * @param watch true (default): a run of TRACE_STALL_US or longer freezes
+ *              the trace ring. Clear it for tasks that are slow by design
+ *              (blocking UART reports, the trace dump itself)
+ */
+void SCHED_set_stall_watch(SCHED_Task_t *const task, bool watch);
+
+/**
+ * @brief Release a task now, ahead of its next periodic release
+ * @param task Pointer to task
+ * @note Safe from interrupt handlers (e.g. an input EXTI). The periodic
+ *       releases stay where they are; the interrupt itself ends WFI.
+ */
+void SCHED_trigger(SCHED_Task_t *const task);
+
+/**
+ * @brief Run the most urgent ready task, or sleep until the next release
+ * @param me Pointer to scheduler instance
+ * @note Call from the main loop: while (1) SCHED_run(&sched);
+ *       Ready tasks are picked earliest-deadline-first. A run of
+ *       TRACE_STALL_US or longer of a stall-watched task freezes the
+ *       trace ring. When nothing is ready the core sleeps in WFI and a
+ *       TIM2 compare wakes it up on time (SysTick still wakes it every
+ *       1 ms for HAL_GetTick()).
+ */
+void SCHED_run(SCHED_t *const me);
+
+/**
+ * @brief Log per-task rate, latency and deadline stats over UART, then reset them
+ * @param me Pointer to scheduler instance
+ */
+void SCHED_report(SCHED_t *const me);
+
+/**
+ * @brief CPU load over the last complete SCHED_LOAD_WINDOW_US
+ * @param me Pointer to scheduler instance
+ * @return Percentage of time not spent asleep in WFI (0..100)
+ * @note Everything outside WFI counts as busy, including interrupt
+ *       handlers and the scheduler itself
+ */
+uint8_t SCHED_cpu_load(const SCHED_t *const me);
+
+/**
+ * @brief Current time on the scheduler time base
+ * @return Microseconds (wraps every ~71 minutes, compare with subtraction)
+ */
+uint32_t SCHED_now_us(void);
+
+/**
+ * @brief Time base interrupt (call from TIM2_IRQHandler)
+ */
+void SCHED_IRQHandler(void);
+
+#endif /* INC_SCHEDULER_H_ */
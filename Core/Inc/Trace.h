@@ -0,0 +1,128 @@
+/*
+ * Trace.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_TRACE_H_
+#define INC_TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Event trace flight recorder
+ *
+ * A fixed RAM ring of timestamped events (DWT cycles): profiler stage and
+ * scheduler task begin/end, I2C transactions, LCD commands and app state
+ * changes. It always holds the most recent TRACE_BUFFER_SIZE events.
+ *
+ * When a scheduled task runs for TRACE_STALL_US or longer the ring is
+ * frozen, so the events leading up to the stall are kept (tasks that are
+ * slow by design opt out with SCHED_set_stall_watch()). TRACE_dump()
+ * then sends them over UART in binary, framed by "TRCE" ... "TEND" so it
+ * can share the port with the text log. Convert a capture with:
+ *
+ *     python3 Tools/trace_to_chrome.py capture.bin trace.json
+ *
+ * and open the result in chrome://tracing or ui.perfetto.dev.
+ *
+ * Build with TRACE_ENABLE=0 and all hooks compile away.
+ */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+#define TRACE_BUFFER_SIZE   512        // Events (8 bytes each), power of 2
+#define TRACE_STALL_US      25000      // Task run that freezes the ring
+
+// Event ids (the dump carries the name of every registered id)
+typedef enum {
+	TRACE_ID_STAGE_BASE = 0,           // + PROF_stage_e
+	TRACE_ID_TASK_BASE = 16,           // + scheduler task index
+	TRACE_ID_I2C_WRITE = 24,
+	TRACE_ID_I2C_READ,
+	TRACE_ID_LCD_CMD,
+	TRACE_ID_STATE,
+	TRACE_MAX_IDS = 32
+} TRACE_id_e;
+
+// Timeline rows in the viewer
+typedef enum {
+	TRACE_TRACK_TASKS = 1,
+	TRACE_TRACK_STAGES,
+	TRACE_TRACK_I2C,
+	TRACE_TRACK_LCD,
+	TRACE_TRACK_APP
+} TRACE_track_e;
+
+typedef enum {
+	TRACE_BEGIN,
+	TRACE_END,
+	TRACE_INSTANT
+} TRACE_type_e;
+
+_Static_assert((TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) == 0,
+		"TRACE_BUFFER_SIZE must be a power of 2");
+
+#if TRACE_ENABLE
+
+typedef struct __attribute__((packed)) {
+	uint32_t timestamp;                // DWT cycles
+	uint8_t type;                      // TRACE_type_e
+	uint8_t id;                        // TRACE_id_e
+	uint16_t arg;                      // Event specific (address, command, state...)
+} TRACE_Event_t;
+
+_Static_assert(sizeof(TRACE_Event_t) == 8, "TRACE_Event_t must stay 8 bytes");
+
+/**
+ * @brief Clear the ring and register the built-in event names
+ */
+void TRACE_init(void);
+
+/**
+ * @brief Name an event id for the viewer
+ * @param id Event id
+ * @param name Static string (not copied)
+ * @param track Timeline row the event is drawn on
+ */
+void TRACE_register(uint8_t id, const char *name, TRACE_track_e track);
+
+/**
+ * @brief Record one event (safe from interrupts, ~20 cycles)
+ */
+void TRACE_record(TRACE_type_e type, uint8_t id, uint16_t arg);
+
+/**
+ * @brief Stop recording so the current contents survive until the next dump
+ * @note Ignored until the ring has filled again after the previous dump
+ */
+void TRACE_freeze(void);
+
+/**
+ * @brief Send the frozen ring over UART (blocking) and resume recording
+ * @return true if a dump was sent
+ */
+bool TRACE_dump(void);
+
+#define TRACE_BEGIN_EVENT(id, arg) TRACE_record(TRACE_BEGIN, (id), (arg))
+#define TRACE_END_EVENT(id, arg) TRACE_record(TRACE_END, (id), (arg))
+#define TRACE_INSTANT_EVENT(id, arg) TRACE_record(TRACE_INSTANT, (id), (arg))
+
+#else /* !TRACE_ENABLE */
+
+#define TRACE_init() ((void) 0)
+#define TRACE_register(id, name, track) ((void) 0)
+#define TRACE_freeze() ((void) 0)
+static inline bool TRACE_dump(void) {
+	return false;
+}
+#define TRACE_BEGIN_EVENT(id, arg) ((void) 0)
+#define TRACE_END_EVENT(id, arg) ((void) 0)
+#define TRACE_INSTANT_EVENT(id, arg) ((void) 0)
+
+#endif /* TRACE_ENABLE */
+
+#endif /* INC_TRACE_H_ */
@@ -0,0 +1,44 @@
+/*
+ * board_config.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_BOARD_CONFIG_H_
+#define INC_BOARD_CONFIG_H_
+
+/*
+ * Build-time board size. Override from the compiler command line
+ * (e.g. -DBOARD_COLS=16 -DBOARD_ROWS=16) to build for a larger matrix.
+ * Index widths in Cell.h are picked automatically from the cell count.
+ */
+#ifndef BOARD_COLS
+#define BOARD_COLS 8
+#endif
+
+#ifndef BOARD_ROWS
+#define BOARD_ROWS (8 * 3) // Three stitched 8x8 panels
+#endif
+
+#define BOARD_CELLS (BOARD_COLS * BOARD_ROWS)
+
+// Largest board the const tables in Cell.c are emitted for
+#define BOARD_MAX_CELLS 1024
+
+#if BOARD_COLS <= 0 || BOARD_ROWS <= 0
+#error "BOARD_COLS and BOARD_ROWS must be positive"
+#endif
+
+#if BOARD_CELLS > BOARD_MAX_CELLS
+#error "Board larger than BOARD_MAX_CELLS, extend the tables in Cell.c"
+#endif
+
+// DISPLAY_t stores each dimension in a byte
+_Static_assert(BOARD_COLS <= 255 && BOARD_ROWS <= 255, "Board dimension exceeds 255");
+
+// The AI builds its Hamiltonian cycle from 2x2 super-cells
+_Static_assert((BOARD_COLS % 2) == 0 && (BOARD_ROWS % 2) == 0,
+		"Board dimensions must be even for the Hamiltonian cycle");
+
+#endif /* INC_BOARD_CONFIG_H_ */
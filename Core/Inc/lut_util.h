@@ -0,0 +1,26 @@
+/*
+ * lut_util.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#ifndef INC_LUT_UTIL_H_
+#define INC_LUT_UTIL_H_
+
+/*
+ * Preprocessor repetition helpers for building const lookup tables in flash.
+ *
+ * LUT_REPEAT_N(M, base) expands to M(base) M(base + 1) ... M(base + N - 1),
+ * so a table entry written as an integer constant expression of its index
+ * is evaluated by the compiler instead of at boot.
+ */
+#define LUT_REPEAT_4(M, n)    M(n) M((n) + 1) M((n) + 2) M((n) + 3)
+#define LUT_REPEAT_16(M, n)   LUT_REPEAT_4(M, n) LUT_REPEAT_4(M, (n) + 4) \
+                              LUT_REPEAT_4(M, (n) + 8) LUT_REPEAT_4(M, (n) + 12)
+#define LUT_REPEAT_64(M, n)   LUT_REPEAT_16(M, n) LUT_REPEAT_16(M, (n) + 16) \
+                              LUT_REPEAT_16(M, (n) + 32) LUT_REPEAT_16(M, (n) + 48)
+#define LUT_REPEAT_256(M, n)  LUT_REPEAT_64(M, n) LUT_REPEAT_64(M, (n) + 64) \
+                              LUT_REPEAT_64(M, (n) + 128) LUT_REPEAT_64(M, (n) + 192)
+
+#endif /* INC_LUT_UTIL_H_ */
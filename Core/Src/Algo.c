@@ -13,6 +13,17 @@
 #define SUPER_ROWS       (DISPLAY_ROWS / SUPER_CELL_SIZE)
 #define SUPER_COLS       (DISPLAY_COLS / SUPER_CELL_SIZE)
 
+// Direction that would reverse onto the body (indexed by key_action_e)
+static const key_action_e OPPOSITE_DIR[ACTION_NONE + 1] = {
+	[ACTION_UP] = ACTION_DOWN,
+	[ACTION_DOWN] = ACTION_UP,
+	[ACTION_LEFT] = ACTION_RIGHT,
+	[ACTION_RIGHT] = ACTION_LEFT,
+	[ACTION_CONFIRM] = ACTION_NONE,
+	[ACTION_HUD] = ACTION_NONE,
+	[ACTION_NONE] = ACTION_NONE,
+};
+
 typedef struct {
 	bool up, down, left, right;
 	bool visited;
@@ -29,24 +40,56 @@ void init_supergrid(void) {
 	}
 }
 
-void visit_node(int x, int y) {
+// Depth-first walk state for one super-cell (explicit stack, no recursion)
+typedef struct {
+	uint8_t x, y;
+	uint8_t dirs[4];   // Shuffled direction order
+	uint8_t next;      // Next entry of dirs to try
+} MST_Frame_t;
+
+static MST_Frame_t mst_stack[SUPER_ROWS * SUPER_COLS];
+
+static void push_node(int *depth, int x, int y) {
+	MST_Frame_t *frame = &mst_stack[(*depth)++];
+
 	supergrid[y][x].visited = true;
+	frame->x = x;
+	frame->y = y;
+	frame->next = 0;
 
 	// Directions: 0=Up, 1=Down, 2=Left, 3=Right
-	int dirs[] = { 0, 1, 2, 3 };
+	for (int i = 0; i < 4; i++)
+		frame->dirs[i] = i;
 
 	// Shuffle directions for randomness
 	for (int i = 0; i < 4; i++) {
 		int r = rand() % 4;
-		int temp = dirs[r];
-		dirs[r] = dirs[i];
-		dirs[i] = temp;
+		uint8_t temp = frame->dirs[r];
+		frame->dirs[r] = frame->dirs[i];
+		frame->dirs[i] = temp;
 	}
+}
 
-	for (int i = 0; i < 4; i++) {
+// Randomized depth-first spanning tree. Iterative so stack use stays
+// constant as the board (and the number of super-cells) grows.
+void visit_node(int start_x, int start_y) {
+	int depth = 0;
+	push_node(&depth, start_x, start_y);
+
+	while (depth > 0) {
+		MST_Frame_t *frame = &mst_stack[depth - 1];
+
+		// All directions tried: backtrack
+		if (frame->next >= 4) {
+			depth--;
+			continue;
+		}
+
+		int x = frame->x, y = frame->y;
+		int dir = frame->dirs[frame->next++];
 		int nx = x, ny = y;
 
-		switch ((key_action_e) dirs[i]) {
+		switch ((key_action_e) dir) {
 		case ACTION_UP:
 			ny--;      // Up
 			break;
@@ -67,22 +110,22 @@ void visit_node(int x, int y) {
 		if (nx >= 0 && nx < SUPER_COLS && ny >= 0 && ny < SUPER_ROWS
 				&& !supergrid[ny][nx].visited) {
 			// Open the wall between current and neighbor
-			if (dirs[i] == 0) {
+			if (dir == 0) {
 				supergrid[y][x].up = true;
 				supergrid[ny][nx].down = true;
-			} else if (dirs[i] == 1) {
+			} else if (dir == 1) {
 				supergrid[y][x].down = true;
 				supergrid[ny][nx].up = true;
-			} else if (dirs[i] == 2) {
+			} else if (dir == 2) {
 				supergrid[y][x].left = true;
 				supergrid[ny][nx].right = true;
-			} else if (dirs[i] == 3) {
+			} else if (dir == 3) {
 				supergrid[y][x].right = true;
 				supergrid[ny][nx].left = true;
 			}
 
-			// Recurse into the neighbor
-			visit_node(nx, ny);
+			// Descend into the neighbor
+			push_node(&depth, nx, ny);
 		}
 	}
 }
@@ -96,8 +139,7 @@ void generate_mst_4x4() {
 void expand_mst_to_hamiltonian(ALGO_t *const me) {
 	int x = 0, y = 0;
 	for (int i = 0; i < MAX_SNAKE_LEN; i++) {
-		me->ham_path[i].x = x;
-		me->ham_path[i].y = y;
+		me->ham_path[i] = CELL_ID(x, y);
 
 		int sx = x / SUPER_CELL_SIZE; // Current super-cell X
 		int sy = y / SUPER_CELL_SIZE; // Current super-cell Y
@@ -129,12 +171,13 @@ void expand_mst_to_hamiltonian(ALGO_t *const me) {
 
 void init_grid_to_index(ALGO_t *const me) {
 	for (int i = 0; i < MAX_SNAKE_LEN; i++) {
-		me->grid_to_index[me->ham_path[i].y][me->ham_path[i].x] = i;
+		me->grid_to_index[me->ham_path[i]] = i;
 	}
 }
 
-void ALGO_ctor(ALGO_t *const me, GAME_Engine_t *game_state) {
+void ALGO_ctor(ALGO_t *const me, GAME_Engine_t *game_state, uint8_t snake_id) {
 	me->game_state = game_state;
+	me->snake_id = snake_id;
 	ALGO_reset(me);
 }
 
@@ -148,99 +191,118 @@ void ALGO_reset(ALGO_t *const me) {
 
 	init_grid_to_index(me);
 
+	me->last_length = 0;
+	me->stall_ticks = 0;
 	me->game_state->game_over = false;
 	log_message("ALGO", LOG_INFO, "Path Generated. Ready to play.");
 }
 
-key_action_e ALGO_get_action(ALGO_t *const me) {
-	C_COORDINATES_t head = me->game_state->body[0];
-	C_COORDINATES_t tail = me->game_state->body[me->game_state->length - 1];
-	C_COORDINATES_t food = me->game_state->food;
+// Distance along the cycle from one index to another (forward only)
+static inline int cycle_distance(int from_idx, int to_idx) {
+	return (to_idx >= from_idx) ?
+			(to_idx - from_idx) : (MAX_SNAKE_LEN - from_idx + to_idx);
+}
+
+// Closest active food ahead of a cycle index
+static int distance_to_food(ALGO_t *const me, int from_idx) {
+	const GAME_Engine_t *game = me->game_state;
+	int best = MAX_SNAKE_LEN + 1; // Longer than any cycle distance
+
+	for (int f = 0; f < game->num_snakes; f++) {
+		if (game->food[f] == CELL_WALL)
+			continue;
+		int dist = cycle_distance(from_idx, me->grid_to_index[game->food[f]]);
+		if (dist < best)
+			best = dist;
+	}
+	return best;
+}
+
+/**
+ * @brief Does any of our own segments sit on the cycle between from_idx and the tail?
+ * @note With a single snake this matches walking the path against the occupancy map
+ */
+static bool body_blocks_path(ALGO_t *const me, const SNAKE_t *snake,
+		int from_idx, int tail_idx) {
+	int span = cycle_distance(from_idx, tail_idx);
+
+	for (CELL_INDEX_t i = 0; i < snake->length; i++) {
+		int seg_idx = me->grid_to_index[SNAKE_segment(snake, i)];
+		if (cycle_distance(from_idx, seg_idx) < span)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Any free neighbour, starting from a random direction so two
+ * snakes can't dodge each other in the same loop forever
+ */
+static key_action_e random_free_move(ALGO_t *const me, CELL_t head,
+		key_action_e reverse_dir, key_action_e fallback) {
+	int first = rand() % CELL_NUM_DIRS;
+
+	for (int n = 0; n < CELL_NUM_DIRS; n++) {
+		key_action_e dir = (key_action_e) ((first + n) % CELL_NUM_DIRS);
+		CELL_t neighbor = CELL_NEIGHBOURS[head][dir];
+		if (neighbor != CELL_WALL && dir != reverse_dir
+				&& me->game_state->occupancy[neighbor] == 0)
+			return dir;
+	}
+	return fallback;
+}
 
-	int head_idx = me->grid_to_index[head.y][head.x];
-	int tail_idx = me->grid_to_index[tail.y][tail.x];
-	int food_idx = me->grid_to_index[food.y][food.x];
-	int current_len = me->game_state->length;
+key_action_e ALGO_get_action(ALGO_t *const me) {
+	const GAME_Engine_t *game = me->game_state;
+	const SNAKE_t *snake = &game->snakes[me->snake_id];
+	CELL_t head = SNAKE_head(snake);
+	CELL_t tail = SNAKE_tail(snake);
+
+	int head_idx = me->grid_to_index[head];
+	int tail_idx = me->grid_to_index[tail];
+	int current_len = snake->length;
+	key_action_e reverse_dir = OPPOSITE_DIR[snake->current_dir];
+
+	// Stall watchdog: never fires for a lone snake. With several snakes,
+	// wander randomly until we eat to break out of a dodge loop.
+	if (snake->length != me->last_length) {
+		me->last_length = snake->length;
+		me->stall_ticks = 0;
+	} else if (me->stall_ticks < STALL_LIMIT) {
+		me->stall_ticks++;
+	} else {
+		return random_free_move(me, head, reverse_dir, snake->current_dir);
+	}
 
 	// Only shortcut if snake is less than half the board size
 	if (current_len < SHORTCUT_THRESHOLD) {
-		int best_dist_to_food = 1000; // Large number
+		int best_dist_to_food = MAX_SNAKE_LEN + 1; // Longer than any cycle distance
 		key_action_e best_action = ACTION_NONE;
 
-		for (int i = 0; i < 4; i++) {
+		for (int i = 0; i < CELL_NUM_DIRS; i++) {
 			key_action_e dir = (key_action_e) i;
-			int nx = head.x, ny = head.y;
-
-			// 1. Calculate neighbor coordinates
-			if (dir == ACTION_UP)
-				ny--;
-			else if (dir == ACTION_DOWN)
-				ny++;
-			else if (dir == ACTION_LEFT)
-				nx--;
-			else if (dir == ACTION_RIGHT)
-				nx++;
-
-			// 2. Validate: Boundary Check
-			if (nx < 0 || nx >= DISPLAY_COLS || ny < 0 || ny >= DISPLAY_ROWS)
-				continue;
 
-			// 3. Validate: 180-degree turn check
-			if ((dir == ACTION_UP && me->game_state->current_dir == ACTION_DOWN)
-					|| (dir == ACTION_DOWN
-							&& me->game_state->current_dir == ACTION_UP)
-					|| (dir == ACTION_LEFT
-							&& me->game_state->current_dir == ACTION_RIGHT)
-					|| (dir == ACTION_RIGHT
-							&& me->game_state->current_dir == ACTION_LEFT))
-				continue;
+			// 1. Neighbour cell (CELL_WALL if off the board)
+			CELL_t neighbor = CELL_NEIGHBOURS[head][dir];
 
-			// 4. Validate: Body Collision
-			bool hits_body = false;
-			for (int b = 0; b < current_len; b++) {
-				if (me->game_state->body[b].x == nx
-						&& me->game_state->body[b].y == ny) {
-					hits_body = true;
-					break;
-				}
-			}
-			if (hits_body)
+			// 2. Validate: Boundary, 180-degree turn and body collision
+			// (occupancy covers every snake on the board)
+			if (neighbor == CELL_WALL || dir == reverse_dir
+					|| game->occupancy[neighbor] != 0)
 				continue;
 
-			int neighbor_idx = me->grid_to_index[ny][nx];
+			int neighbor_idx = me->grid_to_index[neighbor];
 
-			// 5. ROBUST SAFETY RULE: Is the path from Neighbor to Tail completely empty?
-			bool path_is_trapped = false;
-			int walk_idx = neighbor_idx;
-
-			// We walk the Hamiltonian path from the neighbor's index to the tail's index
-			while (walk_idx != tail_idx) {
-				C_COORDINATES_t path_pos = me->ham_path[walk_idx];
-
-				// Check if any part of the snake body is sitting on this path index
-				for (int b = 0; b < current_len; b++) {
-					if (me->game_state->body[b].x == path_pos.x
-							&& me->game_state->body[b].y == path_pos.y) {
-						path_is_trapped = true;
-						break;
-					}
-				}
-
-				if (path_is_trapped)
-					break;
-
-				// Advance to the next index in the 64-step loop
-				walk_idx = (walk_idx + 1) % MAX_SNAKE_LEN;
-			}
+			// 3. ROBUST SAFETY RULE: Is the path from Neighbor to Tail free of our body?
+			// Other snakes keep moving, so only our own segments can trap us
+			bool path_is_trapped = body_blocks_path(me, snake, neighbor_idx,
+					tail_idx);
 
 			if (path_is_trapped)
 				continue; // This shortcut would trap the snake!
 
-			// 6. TARGETING: Pick the move that gets us closest to food in the Hamiltonian sequence
-			int dist_to_food =
-					(food_idx >= neighbor_idx) ?
-							(food_idx - neighbor_idx) :
-							(MAX_SNAKE_LEN - neighbor_idx + food_idx);
+			// 4. TARGETING: Pick the move that gets us closest to food in the Hamiltonian sequence
+			int dist_to_food = distance_to_food(me, neighbor_idx);
 
 			if (dist_to_food < best_dist_to_food) {
 				best_dist_to_food = dist_to_food;
@@ -248,20 +310,32 @@ key_action_e ALGO_get_action(ALGO_t *const me) {
 			}
 		}
 
-		if (best_action != ACTION_NONE)
+		// A lone snake always has the free cycle cell among its candidates.
+		// After dodging another snake our body may lie out of cycle order and
+		// the only "safe" shortcut can be a lap around our own tail: never
+		// prefer that over simply following the cycle.
+		int next_idx = (head_idx + 1) % MAX_SNAKE_LEN;
+		bool cycle_is_better = game->occupancy[me->ham_path[next_idx]] == 0
+				&& distance_to_food(me, next_idx) < best_dist_to_food;
+
+		if (best_action != ACTION_NONE && !cycle_is_better)
 			return best_action;
 	}
 
 	// FALLBACK: Follow the Hamiltonian Cycle strictly
-	C_COORDINATES_t next = me->ham_path[(head_idx + 1) % MAX_SNAKE_LEN];
-	if (next.x > head.x)
-		return ACTION_RIGHT;
-	if (next.x < head.x)
-		return ACTION_LEFT;
-	if (next.y > head.y)
-		return ACTION_DOWN;
-	if (next.y < head.y)
-		return ACTION_UP;
-
-	return ACTION_NONE;
+	CELL_t next = me->ham_path[(head_idx + 1) % MAX_SNAKE_LEN];
+	key_action_e cycle_action = ACTION_NONE;
+	for (int i = 0; i < CELL_NUM_DIRS; i++) {
+		if (CELL_NEIGHBOURS[head][i] == next)
+			cycle_action = (key_action_e) i;
+	}
+
+	// A lone snake always finds its cycle clear (or its own tail, which
+	// moves away). Another snake may block it, or a dodge may have left us
+	// facing backwards along the cycle: then take any free cell instead.
+	if (cycle_action != reverse_dir
+			&& (game->occupancy[next] == 0 || next == tail))
+		return cycle_action;
+
+	return random_free_move(me, head, reverse_dir, cycle_action);
 }
@@ -7,7 +7,9 @@
 
 #include "App_Controller.h"
 #include "debug_logger.h"
-#include <stdio.h>
+#include "Profiler.h"
+#include "Trace.h"
+#include "Latency.h"
 
 /* ========================================================================
  * PRIVATE HELPER FUNCTIONS
@@ -25,6 +27,7 @@ static void transition_to_state(APP_Controller_t *me, APP_State_e new_state) {
 
 	// Log state transitions
 	log_message("APP_CTRL", LOG_INFO, "State: %d -> %d", old_state, new_state);
+	TRACE_INSTANT_EVENT(TRACE_ID_STATE, new_state);
 
 	// Handle state entry logic
 	switch (new_state) {
@@ -32,6 +35,7 @@ static void transition_to_state(APP_Controller_t *me, APP_State_e new_state) {
 		// Entering settings menu
 		me->game_needs_tick = false;
 		me->ui_needs_update = true;
+		me->game->has_moved = false;  // Freeze motion effects
 		break;
 
 	case APP_STATE_PLAYING:
@@ -54,6 +58,7 @@ static void transition_to_state(APP_Controller_t *me, APP_State_e new_state) {
 		// Game frozen while in settings
 		me->game_needs_tick = false;
 		me->ui_needs_update = true;
+		me->game->has_moved = false;
 		break;
 
 	case APP_STATE_GAME_OVER:
@@ -61,10 +66,26 @@ static void transition_to_state(APP_Controller_t *me, APP_State_e new_state) {
 		me->game_needs_tick = false;
 		me->ui_needs_update = true;
 		me->game->game_over = true;
+		me->game->has_moved = false;
 		break;
 	}
 }
 
+/**
+ * @brief CONFIRM on the performance HUD: back to the main page (the game
+ *        keeps its state)
+ * @return true if the HUD was showing
+ */
+static bool leave_perf_page(APP_Controller_t *me) {
+	if (me->ui->current_state != MENU_STATE_PERF)
+		return false;
+
+	CHAR_CANVAS_switch_page(me->ui->canvas, MAIN_PAGE);
+	me->ui->current_state = MENU_STATE_MAIN;
+	me->ui->needs_refresh = true;
+	return true;
+}
+
 /**
  * @brief Handle input when in PLAYING state (MANUAL mode only)
  */
@@ -73,8 +94,10 @@ static void handle_input_playing_manual(APP_Controller_t *me,
 	if (action == ACTION_NONE)
 		return;
 
-	// CONFIRM opens settings menu and pauses game
+	// CONFIRM opens settings menu and pauses game (on the HUD: main page)
 	if (action == ACTION_CONFIRM) {
+		if (leave_perf_page(me))
+			return;
 		me->previous_state = APP_STATE_PLAYING;
 		me->game_was_paused = me->game->game_over; // Remember if game was already paused
 		transition_to_state(me, APP_STATE_MENU);
@@ -86,8 +109,8 @@ static void handle_input_playing_manual(APP_Controller_t *me,
 		return;
 	}
 
-	// All other input goes to the game
-	GAME_update(me->game, action);
+	// Directions stay in the input queue: the next tick takes one turn
+	// from it (apply_queued_turn), so fast sequences aren't collapsed
 }
 
 /**
@@ -98,8 +121,10 @@ static void handle_input_playing_ai(APP_Controller_t *me, key_action_e action) {
 	if (action == ACTION_NONE)
 		return;
 
-	// CONFIRM opens settings menu and pauses game
+	// CONFIRM opens settings menu and pauses game (on the HUD: main page)
 	if (action == ACTION_CONFIRM) {
+		if (leave_perf_page(me))
+			return;
 		me->previous_state = APP_STATE_PLAYING;
 		me->game_was_paused = me->game->game_over;
 		transition_to_state(me, APP_STATE_MENU);
@@ -140,7 +165,29 @@ static void handle_input_menu(APP_Controller_t *me, key_action_e action) {
 		return;
 	}
 
-	// Future: LEFT/RIGHT for other settings
+	// HUD exits settings too, but shows the performance HUD; CONFIRM on
+	// the HUD goes back to the main page
+	if (action == ACTION_HUD) {
+		CHAR_CANVAS_switch_page(me->ui->canvas, PERF_PAGE);
+		me->ui->current_state = MENU_STATE_PERF;
+		me->ui->needs_refresh = true;
+
+		transition_to_state(me, me->previous_state);
+		return;
+	}
+
+	// LEFT/RIGHT to change the number of snakes (a press at the limit
+	// would restart the game for nothing)
+	if (action == ACTION_LEFT && me->game->num_snakes > 1) {
+		APP_CONTROLLER_set_num_snakes(me, me->game->num_snakes - 1);
+		me->ui->needs_refresh = true;
+		return;
+	}
+	if (action == ACTION_RIGHT && me->game->num_snakes < GAME_MAX_SNAKES) {
+		APP_CONTROLLER_set_num_snakes(me, me->game->num_snakes + 1);
+		me->ui->needs_refresh = true;
+		return;
+	}
 }
 
 /**
@@ -150,8 +197,10 @@ static void handle_input_game_over(APP_Controller_t *me, key_action_e action) {
 	if (action == ACTION_NONE)
 		return;
 
-	// CONFIRM opens settings
+	// CONFIRM opens settings (on the HUD: main page)
 	if (action == ACTION_CONFIRM) {
+		if (leave_perf_page(me))
+			return;
 		me->previous_state = APP_STATE_GAME_OVER;
 		transition_to_state(me, APP_STATE_MENU);
 
@@ -166,16 +215,70 @@ static void handle_input_game_over(APP_Controller_t *me, key_action_e action) {
 	transition_to_state(me, APP_STATE_PLAYING);
 }
 
+/**
+ * @brief Steer snake 0 with the oldest queued press that is a real turn
+ *        (MANUAL mode, once per tick)
+ *
+ * Presses that don't change the direction (same way, or a 180-degree
+ * reversal at the time they are reached) are dropped, so UP then LEFT
+ * between two ticks turns on this tick and the next one.
+ */
+static void apply_queued_turn(APP_Controller_t *me) {
+	INPUT_Event_t event;
+
+	while (INPUT_pop_event(me->input, &event)) {
+		if (event.type != INPUT_EVENT_PRESS || event.action > ACTION_RIGHT)
+			continue;
+		if (GAME_update_snake(me->game, 0, (key_action_e) event.action)) {
+			INPUT_record_latency(me->input, &event);
+			LAT_turn(event.timestamp_us);
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Regenerate the Hamiltonian cycle of every active AI player
+ */
+static void reset_ai_players(APP_Controller_t *me) {
+	if (me->ai_players == NULL)
+		return;
+
+	for (int i = 0; i < me->game->num_snakes; i++) {
+		ALGO_reset(&me->ai_players[i]);
+	}
+}
+
+/**
+ * @brief Accumulate tick timing for APP_CONTROLLER_report() (no UART
+ *        output on the tick path)
+ */
+static void record_tick_timing(APP_Controller_t *me, uint32_t ai_cycles,
+		uint32_t tick_cycles) {
+	me->ai_cycles_sum += ai_cycles;
+	me->tick_cycles_sum += tick_cycles;
+	if (tick_cycles > me->tick_cycles_max)
+		me->tick_cycles_max = tick_cycles;
+	if (me->tick_samples < UINT16_MAX)
+		me->tick_samples++;
+}
+
 /* ========================================================================
  * PUBLIC API IMPLEMENTATION
  * ======================================================================== */
 
 void APP_CONTROLLER_ctor(APP_Controller_t *me, GAME_Engine_t *game,
-		APP_UI_t *ui, INPUT_t *input, ALGO_t *ai_player) {
+		APP_UI_t *ui, INPUT_t *input, ALGO_t *ai_players) {
 	me->game = game;
 	me->ui = ui;
 	me->input = input;
-	me->ai_player = ai_player;  // AI always available
+	me->ai_players = ai_players;  // AI always available
+
+	// Tick timing reads CYCCNT, started by TRACE_init() / PROF_init()
+	me->ai_cycles_sum = 0;
+	me->tick_cycles_sum = 0;
+	me->tick_cycles_max = 0;
+	me->tick_samples = 0;
 
 	// Start in AI mode by default (can be changed via UI)
 	me->play_mode = PLAY_MODE_AI;
@@ -196,6 +299,11 @@ void APP_CONTROLLER_process_input(APP_Controller_t *me) {
 	// CRITICAL: Call INPUT_get_action() ONLY ONCE per cycle
 	key_action_e action = INPUT_get_action(me->input);
 
+	// Only manual play consumes queued turns; anywhere else they would
+	// replay later (the press that leaves a state included)
+	bool queue_turns = (me->state == APP_STATE_PLAYING
+			&& me->play_mode == PLAY_MODE_MANUAL);
+
 	// Route input based on current state AND play mode
 	switch (me->state) {
 	case APP_STATE_PLAYING:
@@ -215,29 +323,48 @@ void APP_CONTROLLER_process_input(APP_Controller_t *me) {
 		handle_input_game_over(me, action);
 		break;
 	}
+
+	if (!queue_turns)
+		INPUT_flush_events(me->input);
 }
 
 void APP_CONTROLLER_update(APP_Controller_t *me) {
 	// Only tick the game if we're in PLAYING state
 	if (me->state == APP_STATE_PLAYING && me->game_needs_tick) {
 
+		uint32_t start = DWT->CYCCNT;
+
+		// Human drives snake 0: at most one queued turn per tick
+		if (me->play_mode == PLAY_MODE_MANUAL)
+			apply_queued_turn(me);
+
 		// AI makes its decision HERE at tick rate (5-15 Hz), not at input rate (30 Hz)
-		if (me->play_mode == PLAY_MODE_AI && me->ai_player != NULL) {
-			key_action_e ai_action = ALGO_get_action(me->ai_player);
-			GAME_update(me->game, ai_action);
+		// In MANUAL mode the human drives snake 0, AI drives any others
+		if (me->ai_players != NULL) {
+			int first_ai = (me->play_mode == PLAY_MODE_AI) ? 0 : 1;
+			for (int i = first_ai; i < me->game->num_snakes; i++) {
+				PROF_BEGIN(PROF_ALGO);
+				key_action_e ai_action = ALGO_get_action(&me->ai_players[i]);
+				PROF_END(PROF_ALGO);
+				GAME_update_snake(me->game, i, ai_action);
+			}
 		}
 
-		// Tick the game (move snake, check collisions)
+		uint32_t ai_done = DWT->CYCCNT;
+
+		// Tick the game (move snakes, check collisions)
+		PROF_BEGIN(PROF_GAME_TICK);
 		GAME_tick(me->game);
+		PROF_END(PROF_GAME_TICK);
+
+		record_tick_timing(me, ai_done - start, DWT->CYCCNT - ai_done);
 
 		// Check if game just ended
 		if (me->game->game_over) {
 			transition_to_state(me, APP_STATE_GAME_OVER);
 
 			// Reset AI path when game ends
-			if (me->play_mode == PLAY_MODE_AI && me->ai_player != NULL) {
-				ALGO_reset(me->ai_player);
-			}
+			reset_ai_players(me);
 		}
 
 		// Check if game state changed (stats need updating)
@@ -247,22 +374,33 @@ void APP_CONTROLLER_update(APP_Controller_t *me) {
 	}
 }
 
+void APP_CONTROLLER_report(APP_Controller_t *me) {
+	if (me->tick_samples == 0)
+		return;
+
+	log_message("APP_CTRL", LOG_INFO,
+			"Tick timing (%u ticks): snakes=%u game avg=%lu max=%lu cyc, ai avg=%lu cyc",
+			me->tick_samples, me->game->num_snakes,
+			me->tick_cycles_sum / me->tick_samples, me->tick_cycles_max,
+			me->ai_cycles_sum / me->tick_samples);
+
+	me->ai_cycles_sum = 0;
+	me->tick_cycles_sum = 0;
+	me->tick_cycles_max = 0;
+	me->tick_samples = 0;
+}
+
 void APP_CONTROLLER_render(APP_Controller_t *me) {
 	// Always render the game (visible in background)
+	PROF_BEGIN(PROF_GAME_RENDER);
 	GAME_render(me->game);
+	PROF_END(PROF_GAME_RENDER);
 
 	// Update UI if stats changed
 	if (me->ui_needs_update && me->game->game_state_has_updated) {
-		char buffer[10];
-
-		snprintf(buffer, sizeof(buffer), "%u", me->game->game_counter);
-		APP_UI_update_value(me->ui, CURRENT_GAME_NUM, buffer);
-
-		snprintf(buffer, sizeof(buffer), "%u", me->game->game_won_counter);
-		APP_UI_update_value(me->ui, TOTAL_GAME_WINS, buffer);
-
-		snprintf(buffer, sizeof(buffer), "%u", me->game->length);
-		APP_UI_update_value(me->ui, SNAKE_LEN, buffer);
+		APP_UI_update_int(me->ui, CURRENT_GAME_NUM, me->game->game_counter);
+		APP_UI_update_int(me->ui, TOTAL_GAME_WINS, me->game->game_won_counter);
+		APP_UI_update_int(me->ui, SNAKE_LEN, me->game->snakes[0].length);
 
 		me->game->game_state_has_updated = false;
 		me->ui_needs_update = false;
@@ -277,9 +415,7 @@ void APP_CONTROLLER_toggle_play_mode(APP_Controller_t *me) {
 		log_message("APP_CTRL", LOG_INFO, "Switched to AI mode");
 
 		// Reset AI when switching to AI mode
-		if (me->ai_player != NULL) {
-			ALGO_reset(me->ai_player);
-		}
+		reset_ai_players(me);
 
 		// Update UI to show "AI"
 		APP_UI_update_value(me->ui, PLAY_MODE_DISPLAY, "AI    ");
@@ -295,6 +431,15 @@ void APP_CONTROLLER_toggle_play_mode(APP_Controller_t *me) {
 	}
 }
 
+void APP_CONTROLLER_set_num_snakes(APP_Controller_t *me, uint8_t num_snakes) {
+	GAME_set_num_snakes(me->game, num_snakes);
+	reset_ai_players(me);
+
+	APP_UI_update_int(me->ui, SNAKE_COUNT_DISPLAY, me->game->num_snakes);
+	log_message("APP_CTRL", LOG_INFO, "Snakes on board: %u",
+			me->game->num_snakes);
+}
+
 APP_PlayMode_e APP_CONTROLLER_get_play_mode(APP_Controller_t *me) {
 	return me->play_mode;
 }
@@ -12,19 +12,40 @@
 // Template for main page (40x2 = 80 characters)
 static const char MAIN_PAGE_TEMPLATE[CHAR_DISP_COLS * CHAR_DISP_ROWS] =
     "Game:     Wins:     Snake Len:          "
-    "FPS:                                    ";
+    "FPS:      CPU:    %  I2C err:           ";
 
 // Template for settings page (40x2 = 80 characters)
 // Mode display shows AI or MANUAL, use UP/DOWN to toggle
+// Snake count (multi-snake mode), use LEFT/RIGHT to change
 static const char SETTINGS_PAGE_TEMPLATE[CHAR_DISP_COLS * CHAR_DISP_ROWS] =
-    "        SETTINGS MENU                   "
-    "Mode:         [UP/DOWN to change]       ";
+    "        SETTINGS MENU    Snakes:   [L/R]"
+    "Mode:         [UP/DOWN]    [S8] perf HUD";
+
+// Template for the performance HUD (40x2 = 80 characters)
+// Frame time and LED update in us, CPU and I2C bus busy in %; each
+// followed by a 7 sample history bar
+static const char PERF_PAGE_TEMPLATE[CHAR_DISP_COLS * CHAR_DISP_ROWS] =
+    "Frm      us         CPU      %          "
+    "LED      us         I2C      %          ";
+
+// Value and bar object of each HUD metric
+static const CHAR_CANVAS_obj_e perf_objs[APP_UI_PERF_METRICS][2] = {
+    { PERF_FRAME_US, PERF_FRAME_BAR },
+    { PERF_CPU, PERF_CPU_BAR },
+    { PERF_WIRE_US, PERF_WIRE_BAR },
+    { PERF_I2C, PERF_I2C_BAR },
+};
 
 void APP_UI_ctor(APP_UI_t * const me, CHAR_CANVAS_t * canvas) {
     me->canvas = canvas;
     me->current_state = MENU_STATE_MAIN;
     me->selection_index = 0;
     me->needs_refresh = true;
+
+    for (int i = 0; i < APP_UI_PERF_METRICS; i++) {
+        memset(me->perf_bars[i], ' ', APP_UI_PERF_BAR_LEN);
+        me->perf_bars[i][APP_UI_PERF_BAR_LEN] = '\0';
+    }
 }
 
 void APP_UI_setup_pages(APP_UI_t * const me) {
@@ -44,17 +65,48 @@ void APP_UI_setup_pages(APP_UI_t * const me) {
     // "FPS: XXX" - 3 digits starting at position 6, row 1
     CHAR_CANVAS_obj_init(me->canvas, MAIN_PAGE, GAME_FPS, 6, 1, 3);
 
+    // "CPU: XXX%" - 3 digits starting at position 15, row 1
+    CHAR_CANVAS_obj_init(me->canvas, MAIN_PAGE, CPU_LOAD, 15, 1, 3);
+
+    // "I2C err: XXXXX" - 5 digits starting at position 30, row 1
+    CHAR_CANVAS_obj_init(me->canvas, MAIN_PAGE, I2C_ERRORS, 30, 1, 5);
+
     // Setup SETTINGS_PAGE
     me->canvas->pages[SETTINGS_PAGE].static_template = SETTINGS_PAGE_TEMPLATE;
 
     // "Mode: XXXXXX" - 6 characters starting at position 6, row 1
     CHAR_CANVAS_obj_init(me->canvas, SETTINGS_PAGE, PLAY_MODE_DISPLAY, 6, 1, 6);
 
+    // "Snakes: X" - 1 digit starting at position 33, row 0
+    CHAR_CANVAS_obj_init(me->canvas, SETTINGS_PAGE, SNAKE_COUNT_DISPLAY, 33, 0, 1);
+
+    // Setup PERF_PAGE: value (5 digits) at x + 4, bar at x + 12
+    me->canvas->pages[PERF_PAGE].static_template = PERF_PAGE_TEMPLATE;
+    for (int i = 0; i < APP_UI_PERF_METRICS; i++) {
+        uint8_t x = (i % 2) ? 20 : 0;
+        uint8_t y = i / 2;
+        CHAR_CANVAS_obj_init(me->canvas, PERF_PAGE, perf_objs[i][0], x + 4, y, 5);
+        CHAR_CANVAS_obj_init(me->canvas, PERF_PAGE, perf_objs[i][1], x + 12, y,
+                APP_UI_PERF_BAR_LEN);
+    }
+
+    // Bar glyphs, loaded once: glyph k lights the bottom k + 1 rows
+    for (uint8_t k = 0; k < 8; k++) {
+        uint8_t rows[8];
+        for (uint8_t r = 0; r < 8; r++) {
+            rows[r] = (r >= 7 - k) ? 0x1F : 0x00;
+        }
+        CHAR_DISPLAY_define_glyph(me->canvas->display, k, rows);
+    }
+
     // Initialize default values
-    APP_UI_update_value(me, CURRENT_GAME_NUM, "0");
-    APP_UI_update_value(me, TOTAL_GAME_WINS, "0");
-    APP_UI_update_value(me, SNAKE_LEN, "3");
+    APP_UI_update_int(me, CURRENT_GAME_NUM, 0);
+    APP_UI_update_int(me, TOTAL_GAME_WINS, 0);
+    APP_UI_update_int(me, SNAKE_LEN, 3);
+    APP_UI_update_int(me, CPU_LOAD, 0);
+    APP_UI_update_int(me, I2C_ERRORS, 0);
     APP_UI_update_value(me, PLAY_MODE_DISPLAY, "AI    ");  // Default to AI
+    APP_UI_update_int(me, SNAKE_COUNT_DISPLAY, 1);
 
     // Force initial render
     me->needs_refresh = true;
@@ -79,8 +131,49 @@ void APP_UI_update_value(APP_UI_t * const me, CHAR_CANVAS_obj_e obj_type, const
     me->needs_refresh = true;
 }
 
+void APP_UI_update_int(APP_UI_t * const me, CHAR_CANVAS_obj_e obj_type, uint32_t value) {
+    CHAR_CANVAS_update_int(me->canvas, obj_type, value);
+    if (me->canvas->has_updated) {
+        me->needs_refresh = true;
+    }
+}
+
+// 0 (space) or glyph 1-8, rounding up so any load shows
+static char bar_cell(uint32_t value, uint32_t full_scale) {
+    if (value == 0 || full_scale == 0) return ' ';
+
+    uint32_t level = (value * 8 + full_scale - 1) / full_scale;
+    if (level > 8) level = 8;
+    return (char) (APP_UI_GLYPH_BASE + level - 1);
+}
+
+void APP_UI_update_perf(APP_UI_t * const me, const APP_UI_Perf_t * perf) {
+    // Scales: frame time up to two render periods (a frame on budget sits
+    // at half height), LED update up to one, loads up to 100%
+    const uint32_t values[APP_UI_PERF_METRICS] = { perf->frame_us,
+            perf->cpu_pct, perf->wire_us, perf->i2c_pct };
+    const uint32_t scales[APP_UI_PERF_METRICS] = { 2 * perf->frame_budget_us,
+            100, perf->frame_budget_us, 100 };
+
+    for (int i = 0; i < APP_UI_PERF_METRICS; i++) {
+        char *bar = me->perf_bars[i];
+
+        // Scroll left, newest sample on the right
+        memmove(bar, bar + 1, APP_UI_PERF_BAR_LEN - 1);
+        bar[APP_UI_PERF_BAR_LEN - 1] = bar_cell(values[i], scales[i]);
+
+        APP_UI_update_int(me, perf_objs[i][0], values[i]);
+        CHAR_CANVAS_update_obj(me->canvas, perf_objs[i][1], bar);
+    }
+
+    if (me->canvas->has_updated) {
+        me->needs_refresh = true;
+    }
+}
+
 void APP_UI_refresh(APP_UI_t * const me) {
-    if (me->needs_refresh) {
+    // A budgeted LCD flush still converging needs a call per frame too
+    if (me->needs_refresh || me->canvas->flush_pending) {
         CHAR_CANVAS_render(me->canvas);
         me->needs_refresh = false;
     }
@@ -88,7 +181,7 @@ void APP_UI_refresh(APP_UI_t * const me) {
 
 void APP_UI_force_refresh(APP_UI_t * const me) {
     me->needs_refresh = true;
-    me->canvas->has_updated = true;
+    me->canvas->recompose = true;
     CHAR_CANVAS_render(me->canvas);
     me->needs_refresh = false;
 }
@@ -13,17 +13,15 @@
 static const char *tag = "CANVAS";
 
 static inline void reset_cursor(CANVAS_t *const me) {
-	me->cursor.x = 0;
-	me->cursor.y = 0;
+	me->cursor = 0;
 }
 
 static void move_cursor(CANVAS_t *const me, C_COORDINATES_t postion) {
-	if (postion.x > me->display->size_x || postion.y > me->display->size_y) {
+	if (postion.x >= me->display->size_x || postion.y >= me->display->size_y) {
 		log_message(tag, LOG_ERROR, "Position invalid");
 		return;
 	}
-	me->cursor.x = postion.x;
-	me->cursor.y = postion.y;
+	me->cursor = CELL_ID(postion.x, postion.y);
 }
 
 void CANVAS_ctor(CANVAS_t *const me, DISPLAY_t *display) {
@@ -50,23 +48,30 @@ void CANVAS_draw_point(CANVAS_t *const me, C_COORDINATES_t postion,
 {
 	move_cursor(me, postion);
 
-	uint32_t index = (me->cursor.y * me->display->size_x) + me->cursor.x;
-
-	me->canvas_buffer[index] = color;
+	me->canvas_buffer[me->cursor] = color;
 }
 
 void CANVAS_clear_point(CANVAS_t *const me, C_COORDINATES_t postion)
 {
 	move_cursor(me, postion);
 
-	uint32_t index = (me->cursor.y * me->display->size_x) + me->cursor.x;
+	CANVAS_clear_cell(me, me->cursor);
+}
+
+void CANVAS_draw_cell(CANVAS_t *const me, CELL_t cell, PIXEL_t color)
+{
+	me->cursor = cell;
+	me->canvas_buffer[cell] = color;
+}
 
+void CANVAS_clear_cell(CANVAS_t *const me, CELL_t cell)
+{
 	PIXEL_t color;
 	color.pixels.green = 0;
 	color.pixels.red = 0;
 	color.pixels.blue = 0;
 
-	me->canvas_buffer[index] = color;
+	CANVAS_draw_cell(me, cell, color);
 }
 
 void CANVAS_draw_rectangle(CANVAS_t *const me, C_COORDINATES_t postion,PIXEL_t color, uint8_t length, uint8_t breadth){
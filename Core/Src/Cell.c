@@ -0,0 +1,52 @@
+/*
+ * Cell.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#include "Cell.h"
+#include "lut_util.h"
+
+#define NB_UP(c)    (((c) >= DISPLAY_COLS) ? (c) - DISPLAY_COLS : CELL_WALL)
+#define NB_DOWN(c)  (((c) + DISPLAY_COLS < CELL_COUNT) ? (c) + DISPLAY_COLS : CELL_WALL)
+#define NB_LEFT(c)  (((c) % DISPLAY_COLS != 0) ? (c) - 1 : CELL_WALL)
+#define NB_RIGHT(c) (((c) % DISPLAY_COLS != DISPLAY_COLS - 1) ? (c) + 1 : CELL_WALL)
+
+// Padding entries past CELL_COUNT are walls in every direction
+#define NB_ENTRY(c) \
+	{ ((c) < CELL_COUNT) ? NB_UP(c) : CELL_WALL,   \
+	  ((c) < CELL_COUNT) ? NB_DOWN(c) : CELL_WALL, \
+	  ((c) < CELL_COUNT) ? NB_LEFT(c) : CELL_WALL, \
+	  ((c) < CELL_COUNT) ? NB_RIGHT(c) : CELL_WALL },
+
+// Whole 256-cell blocks first, then 64-cell blocks for the remainder
+#define BLOCKS_256 (CELL_TABLE_SIZE / 256)
+#define BLOCKS_64  ((CELL_TABLE_SIZE % 256) / 64)
+#define TAIL_BASE  (BLOCKS_256 * 256)
+
+const CELL_t CELL_NEIGHBOURS[CELL_TABLE_SIZE][CELL_NUM_DIRS] = {
+#if BLOCKS_256 > 0
+	LUT_REPEAT_256(NB_ENTRY, 0)
+#endif
+#if BLOCKS_256 > 1
+	LUT_REPEAT_256(NB_ENTRY, 256)
+#endif
+#if BLOCKS_256 > 2
+	LUT_REPEAT_256(NB_ENTRY, 512)
+#endif
+#if BLOCKS_256 > 3
+	LUT_REPEAT_256(NB_ENTRY, 768)
+#endif
+#if BLOCKS_64 > 0
+	LUT_REPEAT_64(NB_ENTRY, TAIL_BASE)
+#endif
+#if BLOCKS_64 > 1
+	LUT_REPEAT_64(NB_ENTRY, TAIL_BASE + 64)
+#endif
+#if BLOCKS_64 > 2
+	LUT_REPEAT_64(NB_ENTRY, TAIL_BASE + 128)
+#endif
+};
+
+_Static_assert(BOARD_MAX_CELLS <= 4 * 256, "Extend the CELL_NEIGHBOURS blocks");
@@ -12,12 +12,13 @@
 // Use a private constant for the total screen area
 static const uint16_t TOTAL_CELLS = CHAR_DISP_COLS * CHAR_DISP_ROWS;
 
-static CHAR_CANVAS_Pages_e obj_to_canvas[MAX_OBJECTS];
-
 void CHAR_CANVAS_ctor(CHAR_CANVAS_t * const me, CHAR_DISPLAY_t * display_driver) {
     me->display = display_driver;
     me->has_updated = false;
+    me->recompose = true;
+    me->flush_pending = false;
     me->current_page_idx = MAIN_PAGE;
+    memset(me->obj_page, 0, sizeof(me->obj_page));
 
     // Allocate the main canvas buffer (+1 for a safety null terminator)
     me->canvas_buffer = (char*)calloc(TOTAL_CELLS + 1, sizeof(char));
@@ -30,12 +31,14 @@ void CHAR_CANVAS_ctor(CHAR_CANVAS_t * const me, CHAR_DISPLAY_t * display_driver)
 void CHAR_CANVAS_obj_init(CHAR_CANVAS_t * const me, CHAR_CANVAS_Pages_e page, CHAR_CANVAS_obj_e type, uint8_t x, uint8_t y, uint8_t len) {
     if (type >= MAX_OBJECTS || page >= TOTAL_PAGES) return;
 
-    obj_to_canvas[type] = page; // associates obj page
+    me->obj_page[type] = page; // associates obj page
 
     CHAR_CANVAS_obj_t *obj = &me->pages[page].variable_objs[type];
     obj->x = x;
     obj->y = y;
     obj->length = len;
+    obj->dirty = true;
+    obj->int_valid = false;
 
     // Allocate buffer (+1 for null terminator so string functions work safely)
     obj->buffer = (char*)calloc(len + 1, sizeof(char));
@@ -47,37 +50,96 @@ void CHAR_CANVAS_obj_init(CHAR_CANVAS_t * const me, CHAR_CANVAS_Pages_e page, CH
 void CHAR_CANVAS_update_obj(CHAR_CANVAS_t * const me, CHAR_CANVAS_obj_e type, const char * str) {
     if (type >= MAX_OBJECTS || me->canvas_buffer == NULL) return;
 
-    CHAR_Page_t *page = &me->pages[obj_to_canvas[type]];
+    CHAR_Page_t *page = &me->pages[me->obj_page[type]];
     CHAR_CANVAS_obj_t *obj = &page->variable_objs[type];
 
     if (obj->buffer == NULL) return;
 
-    // First, fill entire buffer with spaces to clear old content
-    memset(obj->buffer, ' ', obj->length);
-
-    // Then copy the new string, but ensure we don't go past obj->length
-    // Using a manual loop to handle the string properly
+    // Copy the new string, padded with spaces to obj->length, noting
+    // whether any character differs from what the object already shows
+    bool changed = false;
     uint8_t i = 0;
     while (str[i] != '\0' && i < obj->length) {
+        changed |= (obj->buffer[i] != str[i]);
         obj->buffer[i] = str[i];
         i++;
     }
-    // Remaining characters are already spaces from memset
-    // No need to pad - memset already did that
+    for (; i < obj->length; i++) {
+        changed |= (obj->buffer[i] != ' ');
+        obj->buffer[i] = ' ';
+    }
 
-    me->has_updated = true;
+    obj->int_valid = false;
+
+    // Same text: nothing for render to do
+    if (changed) {
+        obj->dirty = true;
+        me->has_updated = true;
+    }
+}
+
+void CHAR_CANVAS_update_int(CHAR_CANVAS_t * const me, CHAR_CANVAS_obj_e type, uint32_t value) {
+    if (type >= MAX_OBJECTS) return;
+
+    CHAR_CANVAS_obj_t *obj = &me->pages[me->obj_page[type]].variable_objs[type];
+
+    if (obj->buffer == NULL) return;
+    if (obj->int_valid && obj->last_int == value) return;
+
+    obj->last_int = value;
+    obj->int_valid = true;
+
+    // Clamp to the widest value that fits (10 digits always fit a uint32_t)
+    if (obj->length < 10) {
+        uint32_t max = 9;
+        for (uint8_t i = 1; i < obj->length; i++) {
+            max = (max * 10) + 9;
+        }
+        if (value > max) value = max;
+    }
+
+    // Digits from the right, spaces to the left of the most significant
+    bool changed = false;
+    for (int i = obj->length - 1; i >= 0; i--) {
+        char ch = ' ';
+        if (value != 0 || i == obj->length - 1) {
+            ch = (char) ('0' + (value % 10));
+            value /= 10;
+        }
+        changed |= (obj->buffer[i] != ch);
+        obj->buffer[i] = ch;
+    }
+
+    if (changed) {
+        obj->dirty = true;
+        me->has_updated = true;
+    }
 }
 
 void CHAR_CANVAS_switch_page(CHAR_CANVAS_t * const me, CHAR_CANVAS_Pages_e page) {
     if (page < TOTAL_PAGES) {
         me->current_page_idx = page;
-        me->has_updated = true;
+        me->recompose = true;
     }
 }
 
-void CHAR_CANVAS_render(CHAR_CANVAS_t * const me) {
-    if (!me->has_updated || me->display == NULL) return;
+// Patch the dirty objects of the current page straight into the display
+// buffer; objects on other pages stay dirty until their page is composed
+static void patch_objects(CHAR_CANVAS_t * const me) {
+    CHAR_Page_t *page = &me->pages[me->current_page_idx];
+
+    for (int i = 0; i < MAX_OBJECTS; i++) {
+        CHAR_CANVAS_obj_t *obj = &page->variable_objs[i];
+        if (obj->buffer == NULL || !obj->dirty) continue;
 
+        // obj->buffer is null terminated at obj->length
+        CHAR_WRITE_data(me->display, obj->buffer, obj->x, obj->y);
+        obj->dirty = false;
+    }
+}
+
+// Rebuild the whole page: template, then every object on top of it
+static void compose_page(CHAR_CANVAS_t * const me) {
     CHAR_Page_t *page = &me->pages[me->current_page_idx];
 
     // Layer 1: Load static background or clear the working canvas
@@ -87,11 +149,21 @@ void CHAR_CANVAS_render(CHAR_CANVAS_t * const me) {
         memset(me->canvas_buffer, ' ', TOTAL_CELLS);
     }
 
+#if CHAR_DISPLAY_USE_DIRTY_TRACKING
+    // Widgets reach the LCD before the static text around them
+    CHAR_DISPLAY_reset_priority(me->display);
+#endif
+
     // Layer 2: Overlay dynamic objects onto the canvas
     for (int i = 0; i < MAX_OBJECTS; i++) {
         CHAR_CANVAS_obj_t *obj = &page->variable_objs[i];
         if (obj->buffer == NULL) continue;
 
+#if CHAR_DISPLAY_USE_DIRTY_TRACKING
+        CHAR_DISPLAY_set_priority(me->display, obj->x, obj->y, obj->length,
+                CHAR_DISPLAY_PRIO_HIGH);
+#endif
+
         uint16_t start_pos = (obj->y * CHAR_DISP_COLS) + obj->x;
 
         for (int j = 0; j < obj->length; j++) {
@@ -99,15 +171,40 @@ void CHAR_CANVAS_render(CHAR_CANVAS_t * const me) {
                 me->canvas_buffer[start_pos + j] = obj->buffer[j];
             }
         }
+        obj->dirty = false;
     }
 
     // Layer 3: Sync Canvas to Display Buffer
     // Instead of CHAR_WRITE_data (which relies on \0), we do a direct block copy
-    // because both buffers are the same size (TOTAL_CELLS)
-    memcpy(me->display->buffer, me->canvas_buffer, TOTAL_CELLS);
+    // because both buffers are the same size (TOTAL_CELLS); this also marks
+    // the cells that differ from the LCD for the flush
+    CHAR_DISPLAY_load(me->display, me->canvas_buffer);
+}
+
+void CHAR_CANVAS_render(CHAR_CANVAS_t * const me) {
+    if (me->display == NULL) return;
+
+    // Nothing new: keep converging on the last composition
+    if (!me->has_updated && !me->recompose) {
+        if (me->flush_pending) {
+            me->flush_pending = !CHAR_DISPLAY_buffer_flush(me->display);
+        }
+        return;
+    }
+
+    // A page switch rebuilds everything; otherwise only the widgets that
+    // changed touch the display buffer
+    if (me->recompose) {
+        if (me->canvas_buffer == NULL) return;
+        compose_page(me);
+    } else {
+        patch_objects(me);
+    }
 
     // Physically push the display buffer to the SPLC780D hardware
-    CHAR_DISPLAY_buffer_flush(me->display);
+    // (budgeted: may take a few more calls)
+    me->flush_pending = !CHAR_DISPLAY_buffer_flush(me->display);
 
     me->has_updated = false;
+    me->recompose = false;
 }
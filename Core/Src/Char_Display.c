@@ -6,6 +6,7 @@
  */
 
 #include "Char_Display.h"
+#include "debug_logger.h"
 #include "string.h"
 #include "stdlib.h"
 
@@ -25,6 +26,13 @@ void CHAR_DISPLAY_ctor(CHAR_DISPLAY_t *const me, SPLC780D_t *display_driver) {
 	me->dirty_flags = (bool*) calloc(TOTAL_BUFFER_SIZE, sizeof(bool));
 
 	me->full_refresh_needed = true;
+	me->hw_cursor = -1;
+	memset(me->priority, CHAR_DISPLAY_PRIO_LOW, sizeof(me->priority));
+	me->update_cost = 0;
+	me->cost_max = 0;
+	me->cost_sum = 0;
+	me->updates = 0;
+	me->bridged = 0;
 
 	// Initialize shadow buffer with a different value to force initial update
 	if (me->shadow_buffer != NULL) {
@@ -45,6 +53,7 @@ void CHAR_DISPLAY_clear(CHAR_DISPLAY_t *const me, SPLC780D_t *display_driver) {
 		memset(me->dirty_flags, true, TOTAL_BUFFER_SIZE);
 	}
 	me->full_refresh_needed = true;
+	me->hw_cursor = -1;
 #endif
 
 	// Physically clear the hardware
@@ -74,9 +83,31 @@ void CHAR_WRITE_data(CHAR_DISPLAY_t *const me, char *const str, uint8_t x, uint8
 	}
 }
 
+void CHAR_DISPLAY_define_glyph(CHAR_DISPLAY_t *const me, uint8_t index,
+		const uint8_t rows[8]) {
+	SPLC780D_define_glyph(me->driver, index, rows);
+
 #if CHAR_DISPLAY_USE_DIRTY_TRACKING
+	me->hw_cursor = -1;
+#endif
+}
+
+void CHAR_DISPLAY_load(CHAR_DISPLAY_t *const me, const char *cells) {
+	memcpy(me->buffer, cells, TOTAL_BUFFER_SIZE);
 
-void CHAR_DISPLAY_buffer_flush(CHAR_DISPLAY_t *const me) {
+#if CHAR_DISPLAY_USE_DIRTY_TRACKING
+	// Dirty = differs from what the LCD shows (a cell changed back is clean)
+	if (me->dirty_flags != NULL && me->shadow_buffer != NULL) {
+		for (uint16_t idx = 0; idx < TOTAL_BUFFER_SIZE; idx++) {
+			me->dirty_flags[idx] = (cells[idx] != me->shadow_buffer[idx]);
+		}
+	}
+#endif
+}
+
+#if CHAR_DISPLAY_USE_DIRTY_TRACKING
+
+bool CHAR_DISPLAY_buffer_flush(CHAR_DISPLAY_t *const me) {
 	// If no dirty tracking structures, fall back to full update
 	if (me->dirty_flags == NULL || me->shadow_buffer == NULL) {
 		// Fallback: full buffer update
@@ -87,51 +118,93 @@ void CHAR_DISPLAY_buffer_flush(CHAR_DISPLAY_t *const me) {
 				SPLC780D_write_char(me->driver, c);
 			}
 		}
-		return;
+		return true;
 	}
 
-	// Optimized dirty tracking mode
+	// Full refresh: forget what the LCD shows, every cell differs
 	if (me->full_refresh_needed) {
-		// Full refresh: update everything and reset tracking
-		for (uint8_t row = 0; row < CHAR_DISP_ROWS; row++) {
-			SPLC780D_move_cursor(me->driver, 0, row);
-			for (uint8_t col = 0; col < CHAR_DISP_COLS; col++) {
-				uint16_t idx = (row * CHAR_DISP_COLS) + col;
-				char c = me->buffer[idx];
-				SPLC780D_write_char(me->driver, c);
-				me->shadow_buffer[idx] = c;
-				me->dirty_flags[idx] = false;
-			}
-		}
+		memset(me->shadow_buffer, 0xFF, TOTAL_BUFFER_SIZE);
+		memset(me->dirty_flags, true, TOTAL_BUFFER_SIZE);
+		me->hw_cursor = -1;
 		me->full_refresh_needed = false;
-	} else {
-		// Incremental update: only update changed characters
-		for (uint8_t row = 0; row < CHAR_DISP_ROWS; row++) {
-			bool cursor_positioned = false;
+	}
 
-			for (uint8_t col = 0; col < CHAR_DISP_COLS; col++) {
-				uint16_t idx = (row * CHAR_DISP_COLS) + col;
-
-				// Check if this character has changed
-				if (me->buffer[idx] != me->shadow_buffer[idx]) {
-					// Position cursor only when needed
-					if (!cursor_positioned) {
-						SPLC780D_move_cursor(me->driver, col, row);
-						cursor_positioned = true;
-					}
-
-					// Write the changed character
-					char c = me->buffer[idx];
-					SPLC780D_write_char(me->driver, c);
-					me->shadow_buffer[idx] = c;
-					me->dirty_flags[idx] = false;
-				} else {
-					// Character unchanged, cursor needs repositioning for next write
-					cursor_positioned = false;
+	// Previous slice still going out: don't queue behind it
+	if (!SPLC780D_idle(me->driver)) {
+		return false;
+	}
+
+	// Plan spans of dirty cells, high priority first. Within a row, the
+	// gap to the next dirty cell of the same priority is rewritten when
+	// that is no dearer than a cursor move (the LCD auto-increments)
+	uint16_t budget = CHAR_DISPLAY_FLUSH_BUDGET;
+
+	for (int level = CHAR_DISPLAY_PRIO_LEVELS - 1; level >= 0; level--) {
+		for (uint16_t idx = 0; idx < TOTAL_BUFFER_SIZE; idx++) {
+			if (!me->dirty_flags[idx] || me->priority[idx] != level) {
+				continue;
+			}
+
+			// Extend the span [idx, end) along the row
+			uint16_t row_end = (idx / CHAR_DISP_COLS + 1) * CHAR_DISP_COLS;
+			uint16_t end = idx + 1;
+			uint16_t gap = 0;
+			for (uint16_t next = end; next < row_end; next++) {
+				if (me->dirty_flags[next] && me->priority[next] == level) {
+					end = next + 1;
+					gap = 0;
+				} else if (++gap * CHAR_DISPLAY_COST_CHAR > CHAR_DISPLAY_COST_MOVE) {
+					break;
 				}
 			}
+
+			// Position cursor only when needed
+			bool positioned = (me->hw_cursor == (int16_t) idx);
+			uint16_t move_cost = positioned ? 0 : CHAR_DISPLAY_COST_MOVE;
+			if (move_cost + CHAR_DISPLAY_COST_CHAR > budget) {
+				return false;          // Resume here next call
+			}
+
+			// A span cut short by the budget resumes on the next call
+			uint16_t fit = (budget - move_cost) / CHAR_DISPLAY_COST_CHAR;
+			if (end - idx > fit) {
+				end = idx + fit;
+			}
+			budget -= move_cost + (end - idx) * CHAR_DISPLAY_COST_CHAR;
+			me->update_cost += move_cost + (end - idx) * CHAR_DISPLAY_COST_CHAR;
+
+			if (!positioned) {
+				SPLC780D_move_cursor(me->driver, idx % CHAR_DISP_COLS,
+						idx / CHAR_DISP_COLS);
+			}
+
+			for (uint16_t cell = idx; cell < end; cell++) {
+				char c = me->buffer[cell];
+				if (!me->dirty_flags[cell]) {
+					me->bridged++;
+				}
+				SPLC780D_write_char(me->driver, c);
+				me->shadow_buffer[cell] = c;
+				me->dirty_flags[cell] = false;
+			}
+
+			// The address counter doesn't wrap from the end of row 0 to row 1
+			me->hw_cursor = (end % CHAR_DISP_COLS) ? (int16_t) end : -1;
+			idx = end - 1;
+		}
+	}
+
+	// Converged: account the whole update, however many calls it took
+	if (me->update_cost != 0) {
+		me->updates++;
+		me->cost_sum += me->update_cost;
+		if (me->update_cost > me->cost_max) {
+			me->cost_max = me->update_cost;
 		}
+		me->update_cost = 0;
 	}
+
+	return true;
 }
 
 void CHAR_DISPLAY_force_refresh(CHAR_DISPLAY_t *const me) {
@@ -139,10 +212,39 @@ void CHAR_DISPLAY_force_refresh(CHAR_DISPLAY_t *const me) {
 	CHAR_DISPLAY_buffer_flush(me);
 }
 
+void CHAR_DISPLAY_set_priority(CHAR_DISPLAY_t *const me, uint8_t x, uint8_t y,
+		uint8_t len, CHAR_DISPLAY_prio_e level) {
+	if (y >= CHAR_DISP_ROWS || x >= CHAR_DISP_COLS)
+		return;
+
+	if (len > CHAR_DISP_COLS - x)
+		len = CHAR_DISP_COLS - x;
+	memset(&me->priority[(y * CHAR_DISP_COLS) + x], level, len);
+}
+
+void CHAR_DISPLAY_reset_priority(CHAR_DISPLAY_t *const me) {
+	memset(me->priority, CHAR_DISPLAY_PRIO_LOW, sizeof(me->priority));
+}
+
+void CHAR_DISPLAY_report(CHAR_DISPLAY_t *const me) {
+	if (me->updates == 0) {
+		return;
+	}
+
+	log_message("LCD", LOG_INFO,
+			"%lu updates, I2C transactions per update avg %lu max %u, %lu cells bridged",
+			me->updates, me->cost_sum / me->updates, me->cost_max, me->bridged);
+
+	me->updates = 0;
+	me->cost_sum = 0;
+	me->cost_max = 0;
+	me->bridged = 0;
+}
+
 #else // !CHAR_DISPLAY_USE_DIRTY_TRACKING
 
 // Original implementation without dirty tracking
-void CHAR_DISPLAY_buffer_flush(CHAR_DISPLAY_t *const me) {
+bool CHAR_DISPLAY_buffer_flush(CHAR_DISPLAY_t *const me) {
 	for (uint8_t row = 0; row < CHAR_DISP_ROWS; row++) {
 		// 1. Position the hardware cursor at start of line
 		SPLC780D_move_cursor(me->driver, 0, row);
@@ -153,6 +255,7 @@ void CHAR_DISPLAY_buffer_flush(CHAR_DISPLAY_t *const me) {
 			SPLC780D_write_char(me->driver, c);
 		}
 	}
+	return true;
 }
 
 #endif // CHAR_DISPLAY_USE_DIRTY_TRACKING
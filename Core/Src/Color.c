@@ -0,0 +1,45 @@
+/*
+ * Color.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#include "Color.h"
+#include "lut_util.h"
+
+#define WHEEL_ENTRY(h) \
+	{ .pixels = { .green = COLOR_HUE_GREEN(h), .red = COLOR_HUE_RED(h), .blue = COLOR_HUE_BLUE(h) } },
+
+const PIXEL_t COLOR_HUE_WHEEL[COLOR_HUE_STEPS] = {
+	LUT_REPEAT_256(WHEEL_ENTRY, 0)
+};
+
+// Linear fade between two grey levels, truncated like the old float version
+#define FOOD_START 255U
+#define FOOD_END   50U
+#define FOOD_LEVEL(i) \
+	((FOOD_START * (COLOR_FOOD_LUT_SIZE - 1) - (FOOD_START - FOOD_END) * (i)) \
+			/ (COLOR_FOOD_LUT_SIZE - 1))
+#define FOOD_ENTRY(i) \
+	{ .pixels = { .green = FOOD_LEVEL(i), .red = FOOD_LEVEL(i), .blue = FOOD_LEVEL(i) } },
+
+const PIXEL_t COLOR_FOOD_LUT[COLOR_FOOD_LUT_SIZE] = {
+	LUT_REPEAT_16(FOOD_ENTRY, 0)
+	LUT_REPEAT_4(FOOD_ENTRY, 16)
+};
+
+_Static_assert(COLOR_FOOD_LUT_SIZE == 16 + 4, "COLOR_FOOD_LUT initializer out of sync");
+
+PIXEL_t COLOR_hsv_to_rgb(uint8_t hue, uint8_t sat, uint8_t val) {
+	PIXEL_t color = COLOR_HUE_WHEEL[hue];
+
+	// Desaturate towards white, then scale by value
+	uint16_t sat_factor = (uint16_t) sat + 1;
+	for (int i = 0; i < PIXEL_SIZE; i++) {
+		uint8_t c = color.pixel_array[i];
+		color.pixel_array[i] = (uint8_t) (255U - (((255U - c) * sat_factor) >> 8));
+	}
+
+	return COLOR_scale(color, val);
+}
@@ -0,0 +1,44 @@
+/*
+ * Effects.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#include "Effects.h"
+#include "Color.h"
+
+void EFFECTS_ctor(EFFECTS_t *const me, GAME_Engine_t *game) {
+	me->game = game;
+	me->canvas = game->canvas;
+}
+
+void EFFECTS_apply(EFFECTS_t *const me, uint8_t phase) {
+	GAME_Engine_t *game = me->game;
+
+	// Nothing moved on the last tick (paused, waiting for input, reset)
+	if (!game->has_moved)
+		return;
+
+	for (int s = 0; s < game->num_snakes; s++) {
+		SNAKE_t *snake = &game->snakes[s];
+		if (!snake->has_moved)
+			continue;
+
+		CELL_t head = SNAKE_head(snake);
+
+		// 1. Head fades in over the tick period
+		CANVAS_draw_cell(me->canvas, head,
+				COLOR_scale(GAME_get_segment_color(game, s, 0), phase));
+
+		// 2. Tail fades out of the cell it just left
+		// (skip if a head moved straight into it or food spawned there)
+		if (game->occupancy[snake->vacated] == 0
+				&& !GAME_is_food(game, snake->vacated)) {
+			PIXEL_t tail_color = GAME_get_segment_color(game, s,
+					snake->length - 1);
+			CANVAS_draw_cell(me->canvas, snake->vacated,
+					COLOR_scale(tail_color, EFFECTS_PHASE_FULL - phase));
+		}
+	}
+}
@@ -6,30 +6,93 @@
  */
 
 #include "FPS_counter_util.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint16_t bucket_of(uint32_t frame_us) {
+    uint32_t bucket = frame_us / FPS_HIST_BUCKET_US;
+    return (bucket < FPS_HIST_BUCKETS) ? bucket : FPS_HIST_BUCKETS - 1;
+}
+
+static void record_frame(FPS_Counter_t *me, uint32_t frame_us) {
+    // Window full: the oldest frame leaves before the new one enters
+    if (me->samples == FPS_WINDOW_FRAMES) {
+        uint32_t oldest = me->frame_us[me->head];
+        me->hist[bucket_of(oldest)]--;
+        me->sum_us -= oldest;
+        me->sum_sq_us -= (uint64_t) oldest * oldest;
+    } else {
+        me->samples++;
+    }
+
+    me->frame_us[me->head] = frame_us;
+    me->head = (me->head + 1) & (FPS_WINDOW_FRAMES - 1);
+    me->hist[bucket_of(frame_us)]++;
+    me->sum_us += frame_us;
+    me->sum_sq_us += (uint64_t) frame_us * frame_us;
+}
+
+// Upper edge of the bucket holding the sample of the given rank (1-based),
+// capped at the real maximum (the last bucket is open-ended)
+static uint32_t percentile(const FPS_Counter_t *me, uint32_t rank, uint32_t max_us) {
+    uint32_t seen = 0;
+    for (uint16_t b = 0; b < FPS_HIST_BUCKETS; b++) {
+        seen += me->hist[b];
+        if (seen >= rank) {
+            uint32_t edge = (uint32_t) (b + 1) * FPS_HIST_BUCKET_US;
+            return (b == FPS_HIST_BUCKETS - 1 || edge > max_us) ? max_us : edge;
+        }
+    }
+    return max_us;
+}
+
+static uint32_t isqrt(uint64_t x) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > x)
+        bit >>= 2;
+    while (bit != 0) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t) root;
+}
 
 void FPS_ctor(FPS_Counter_t *me, uint32_t update_interval_ms) {
-    me->frame_count = 0;
-    me->last_update_tick = 0;
-    me->fps = 0;
-    me->update_interval = update_interval_ms;
+    memset(me, 0, sizeof(*me));
+    me->update_interval = update_interval_ms * 1000;
 }
 
-uint32_t FPS_tick(FPS_Counter_t *me, uint32_t current_tick) {
+uint32_t FPS_tick(FPS_Counter_t *me, uint32_t now_us) {
     // Increment frame count every time this is called
     me->frame_count++;
 
+    // Frame time: start of this frame minus start of the previous one
+    if (me->has_last_frame) {
+        record_frame(me, now_us - me->last_frame);
+    }
+    me->last_frame = now_us;
+    me->has_last_frame = true;
+
     // Calculate elapsed time since last FPS update
-    uint32_t elapsed = current_tick - me->last_update_tick;
+    uint32_t elapsed = now_us - me->last_update_tick;
 
     // Update FPS calculation if enough time has passed
     if (elapsed >= me->update_interval) {
-        // FPS = frames / (elapsed_ms / 1000)
-        // Multiply by 1000 first to avoid float division
-        me->fps = (me->frame_count * 1000) / elapsed;
+        // FPS = frames / (elapsed_us / 1000000)
+        // Round to nearest, 64-bit to avoid overflow
+        me->fps = (uint32_t) (((uint64_t) me->frame_count * 1000000 + elapsed / 2) / elapsed);
 
         // Reset for next measurement period
         me->frame_count = 0;
-        me->last_update_tick = current_tick;
+        me->last_update_tick = now_us;
     }
 
     return me->fps;
@@ -39,8 +102,57 @@ uint32_t FPS_get(FPS_Counter_t *me) {
     return me->fps;
 }
 
+void FPS_get_pacing(const FPS_Counter_t *me, FPS_Pacing_t *out) {
+    memset(out, 0, sizeof(*out));
+    if (me->samples == 0) return;
+
+    uint32_t n = me->samples;
+    for (uint32_t i = 0; i < n; i++) {
+        if (me->frame_us[i] > out->max_us) out->max_us = me->frame_us[i];
+    }
+
+    out->frames = (uint16_t) n;
+    out->avg_us = (uint32_t) (me->sum_us / n);
+
+    // Rank ceil(n * p / 100) for p50/p95/p99
+    out->p50_us = percentile(me, (n * 50 + 99) / 100, out->max_us);
+    out->p95_us = percentile(me, (n * 95 + 99) / 100, out->max_us);
+    out->p99_us = percentile(me, (n * 99 + 99) / 100, out->max_us);
+
+    // Variance = E[x^2] - E[x]^2
+    uint64_t mean_sq = me->sum_sq_us / n;
+    uint64_t sq_mean = (uint64_t) out->avg_us * out->avg_us;
+    out->jitter_us = (mean_sq > sq_mean) ? isqrt(mean_sq - sq_mean) : 0;
+}
+
+void FPS_report(const FPS_Counter_t *me) {
+    FPS_Pacing_t pacing;
+    FPS_get_pacing(me, &pacing);
+    if (pacing.frames == 0) return;
+
+    log_message("FPS", LOG_INFO,
+            "Frame time over %u frames: avg %lu p50 %lu p95 %lu p99 %lu max %lu jitter %lu us",
+            pacing.frames, pacing.avg_us, pacing.p50_us, pacing.p95_us,
+            pacing.p99_us, pacing.max_us, pacing.jitter_us);
+
+    // Only non-empty buckets, as "<upper_ms:count"
+    char hist[192];                 // One log line (log_message truncates at 256)
+    int len = 0;
+    hist[0] = '\0';
+    for (uint16_t b = 0; b < FPS_HIST_BUCKETS && len < (int) sizeof(hist); b++) {
+        if (me->hist[b] == 0) continue;
+        // The last bucket is open-ended: show its lower edge instead
+        bool last = (b == FPS_HIST_BUCKETS - 1);
+        uint32_t edge = (uint32_t) (last ? b : b + 1) * FPS_HIST_BUCKET_US;
+        len += snprintf(hist + len, sizeof(hist) - len, " %s%lu.%lu:%u",
+                last ? ">=" : "<", edge / 1000, (edge % 1000) / 100, me->hist[b]);
+    }
+    log_message("FPS", LOG_INFO, "Frame time hist (ms):%s", hist);
+}
+
 void FPS_reset(FPS_Counter_t *me) {
-    me->frame_count = 0;
-    me->fps = 0;
-    me->last_update_tick = 0;
+    uint32_t update_interval = me->update_interval;
+
+    memset(me, 0, sizeof(*me));
+    me->update_interval = update_interval;
 }
@@ -8,84 +8,17 @@
 #include "Game.h"
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
-
-#define FOOD_LUT_SIZE 20
-static PIXEL_t food_color_lut[FOOD_LUT_SIZE];
-
-#define SNAKE_LUT_SIZE MAX_SNAKE_LEN // Larger size = smoother rainbow
-static PIXEL_t snake_color_lut[SNAKE_LUT_SIZE];
-
-void generate_food_color_lut() {
-	// 1. Set start and end points
-	food_color_lut[0].pixels.red = 255;
-	food_color_lut[0].pixels.green = 255;
-	food_color_lut[0].pixels.blue = 255;
-
-	food_color_lut[FOOD_LUT_SIZE - 1].pixels.red = 50;
-	food_color_lut[FOOD_LUT_SIZE - 1].pixels.green = 50;
-	food_color_lut[FOOD_LUT_SIZE - 1].pixels.blue = 50;
-
-	// 2. Calculate steps using floats to maintain precision
-	float r_start = (float) food_color_lut[0].pixels.red;
-	float g_start = (float) food_color_lut[0].pixels.green;
-	float b_start = (float) food_color_lut[0].pixels.blue;
-
-	float r_end = (float) food_color_lut[FOOD_LUT_SIZE - 1].pixels.red;
-	float g_end = (float) food_color_lut[FOOD_LUT_SIZE - 1].pixels.green;
-	float b_end = (float) food_color_lut[FOOD_LUT_SIZE - 1].pixels.blue;
-
-	float dr = (r_end - r_start) / (FOOD_LUT_SIZE - 1);
-	float dg = (g_end - g_start) / (FOOD_LUT_SIZE - 1);
-	float db = (b_end - b_start) / (FOOD_LUT_SIZE - 1);
-
-	// 3. Fill the table (start from index 1)
-	for (int i = 1; i < FOOD_LUT_SIZE - 1; i++) {
-		food_color_lut[i].pixels.red = (uint8_t) (r_start + (dr * i));
-		food_color_lut[i].pixels.green = (uint8_t) (g_start + (dg * i));
-		food_color_lut[i].pixels.blue = (uint8_t) (b_start + (db * i));
-	}
-}
+#include "Color.h"
 
-void generate_snake_rainbow_lut() {
-	for (int i = 0; i < SNAKE_LUT_SIZE; i++) {
-		float hue = (float) i / SNAKE_LUT_SIZE;
-		float r, g, b;
-
-		// Standard Hue-to-RGB conversion
-		float h = hue * 6.0f;
-		float x = (1.0f - fabsf(fmodf(h, 2.0f) - 1.0f));
-
-		if (h < 1) {
-			r = 1;
-			g = x;
-			b = 0;
-		} else if (h < 2) {
-			r = x;
-			g = 1;
-			b = 0;
-		} else if (h < 3) {
-			r = 0;
-			g = 1;
-			b = x;
-		} else if (h < 4) {
-			r = 0;
-			g = x;
-			b = 1;
-		} else if (h < 5) {
-			r = x;
-			g = 0;
-			b = 1;
-		} else {
-			r = 1;
-			g = 0;
-			b = x;
-		}
+// Each snake's rainbow starts at its own hue so snakes stay distinguishable
+static inline uint32_t get_snake_hue_offset(GAME_Engine_t *me, uint8_t snake_id) {
+	return ((uint32_t) snake_id * COLOR_HUE_STEPS) / me->num_snakes;
+}
 
-		snake_color_lut[i].pixels.red = (uint8_t) (r * 255);
-		snake_color_lut[i].pixels.green = (uint8_t) (g * 255);
-		snake_color_lut[i].pixels.blue = (uint8_t) (b * 255);
-	}
+// Rainbow along the body: segment i gets hue i/MAX_SNAKE_LEN of the wheel
+static inline PIXEL_t get_snake_color(uint32_t hue_offset, CELL_INDEX_t index) {
+	uint32_t hue = ((uint32_t) index * COLOR_HUE_STEPS) / MAX_SNAKE_LEN;
+	return COLOR_HUE_WHEEL[(hue + hue_offset) % COLOR_HUE_STEPS];
 }
 
 void GAME_ctor(GAME_Engine_t *const me, CANVAS_t *canvas) {
@@ -94,140 +27,297 @@ void GAME_ctor(GAME_Engine_t *const me, CANVAS_t *canvas) {
 	me->game_won_counter = 0;
 	me->game_state_has_updated = true;
 	me->level_tick_rate = 5;  // Default to manual mode speed
+	me->num_snakes = 1;       // Classic single snake
 
-	generate_food_color_lut();
-	generate_snake_rainbow_lut();
 	GAME_reset(me);
 }
 
 inline static PIXEL_t get_food_color(GAME_Engine_t *me) {
-	if (FOOD_LUT_SIZE <= me->food_color)
+	if (COLOR_FOOD_LUT_SIZE <= me->food_color)
 		me->food_color = 0;
-	return food_color_lut[me->food_color++];
+	return COLOR_FOOD_LUT[me->food_color++];
 }
 
-void move_snake(GAME_Engine_t *me) {
-	// 1. Shift the body: Start from the tail, move each segment to the position of the one before it
-	for (int i = me->length - 1; i > 0; i--) {
-		me->body[i] = me->body[i - 1];
-	}
+// Shared occupancy bookkeeping (one segment enters/leaves a cell)
+static inline void occupy(GAME_Engine_t *me, CELL_t cell) {
+	if (me->occupancy[cell]++ == 0)
+		me->occupied_cells++;
+}
+
+static inline void release(GAME_Engine_t *me, CELL_t cell) {
+	if (--me->occupancy[cell] == 0)
+		me->occupied_cells--;
+}
 
-	// 2. Move the Head based on current direction
-	switch (me->current_dir) {
-	case ACTION_UP:
-		me->body[0].y--;
-		break;
-	case ACTION_DOWN:
-		me->body[0].y++;
-		break;
-	case ACTION_LEFT:
-		me->body[0].x--;
-		break;
-	case ACTION_RIGHT:
-		me->body[0].x++;
-		break;
-	default:
-		break;
+static inline bool is_free(GAME_Engine_t *me, CELL_t cell) {
+	return me->occupancy[cell] == 0 && !GAME_is_food(me, cell);
+}
+
+// Cells neither occupied by a snake nor holding active food
+static inline int free_cells(GAME_Engine_t *me) {
+	int free = CELL_COUNT - me->occupied_cells;
+	for (int f = 0; f < me->num_snakes; f++) {
+		if (me->food[f] != CELL_WALL)
+			free--;
 	}
+	return free;
+}
+
+void move_snake(GAME_Engine_t *me, SNAKE_t *snake) {
+	// Single table load; CELL_WALL if the move leaves the board
+	CELL_t next = CELL_NEIGHBOURS[SNAKE_head(snake)][snake->current_dir];
+
+	// Remember where the tail was so the effects stage can fade it out
+	snake->vacated = SNAKE_tail(snake);
+	release(me, snake->vacated);
+
+	// Push the new head into the ring: the old tail slot simply drops out
+	snake->head = (snake->head == 0) ? MAX_SNAKE_LEN - 1 : snake->head - 1;
+	snake->body[snake->head] = next;
+	if (next != CELL_WALL)
+		occupy(me, next);
 }
 
-void spawn_food(GAME_Engine_t *const me) {
-	if (MAX_SNAKE_LEN <= me->length) {
+/**
+ * @brief Place a food item on a random free cell
+ * @return false if the board is full (game won and reset)
+ */
+bool spawn_food(GAME_Engine_t *const me, uint8_t slot) {
+	me->food[slot] = CELL_WALL; // Eaten: don't count the old position as taken
+
+	bool board_full = free_cells(me) <= 0;
+	for (int i = 0; i < me->num_snakes && !board_full; i++) {
+		board_full = MAX_SNAKE_LEN <= me->snakes[i].length;
+	}
+
+	if (board_full) {
 		me->game_won_counter++;
 		GAME_reset(me);
-		return;
+		return false;
 	}
 
-	bool on_snake;
 	me->food_color = 0;
+	CELL_t cell;
 	do {
-		on_snake = false;
-		me->food.x = rand() % DISPLAY_COLS;
-		me->food.y = rand() % DISPLAY_ROWS;
-
-		// Make sure food didn't spawn on the snake body
-		for (int i = 0; i < me->length; i++) {
-			if (me->food.x == me->body[i].x && me->food.y == me->body[i].y) {
-				on_snake = true;
-				break;
-			}
-		}
-	} while (on_snake); // Keep trying until we find a clear spot
+		cell = rand() % CELL_COUNT;
+	} while (!is_free(me, cell)); // Keep trying until we find a clear spot
+	me->food[slot] = cell;
+	return true;
 }
 
-void check_collisions(GAME_Engine_t *const me) {
-	C_COORDINATES_t head = me->body[0];
+// Start a snake of length 1 on a random free cell, waiting for a direction
+static void spawn_snake(GAME_Engine_t *const me, SNAKE_t *snake) {
+	CELL_t cell;
+	do {
+		cell = rand() % CELL_COUNT;
+	} while (!is_free(me, cell));
+
+	snake->head = 0;
+	snake->body[0] = cell;
+	snake->length = 1;
+	snake->current_dir = ACTION_NONE;
+	snake->has_moved = false;
+	occupy(me, cell);
+}
 
-	// 1. Wall Collision (Checking >= 8 handles wrap-around for uint8_t)
-	if (head.x >= me->canvas->display->size_x
-			|| head.y >= me->canvas->display->size_y) {
-		GAME_reset(me);
-		return;
+// Remove a dead snake's body from the shared occupancy
+static void kill_snake(GAME_Engine_t *const me, SNAKE_t *snake) {
+	for (CELL_INDEX_t i = 0; i < snake->length; i++) {
+		CELL_t cell = SNAKE_segment(snake, i);
+		if (cell != CELL_WALL)
+			release(me, cell);
 	}
+	snake->has_moved = false;
+}
 
-	// 2. Self Collision (Start checking from index 1 to length)
-	for (int i = 1; i < me->length; i++) {
-		if (head.x == me->body[i].x && head.y == me->body[i].y) {
+static void grow_snake(GAME_Engine_t *const me, SNAKE_t *snake) {
+	if (snake->length < MAX_SNAKE_LEN) {
+		// New segment starts on top of the tail and separates next tick
+		CELL_t tail = SNAKE_tail(snake);
+		snake->length++;
+		uint32_t slot = (uint32_t) snake->head + snake->length - 1;
+		if (slot >= MAX_SNAKE_LEN)
+			slot -= MAX_SNAKE_LEN;
+		snake->body[slot] = tail;
+		occupy(me, tail);
+		me->game_state_has_updated = true;
+	}
+}
+
+/**
+ * @brief Resolve collisions of all snakes in one pass
+ * @return false if the game was reset
+ */
+bool check_collisions(GAME_Engine_t *const me) {
+	uint8_t dead_mask = 0;
+
+	// 1. Wall, self and snake-vs-snake collisions: after every snake has
+	// moved, a head is dead if it left the board or shares its cell with
+	// any other segment (own body, another body, or another head)
+	for (int i = 0; i < me->num_snakes; i++) {
+		SNAKE_t *snake = &me->snakes[i];
+		if (!snake->has_moved)
+			continue;
+
+		CELL_t head = SNAKE_head(snake);
+		if (head == CELL_WALL || me->occupancy[head] > 1)
+			dead_mask |= 1U << i;
+	}
+
+	if (dead_mask != 0) {
+		// Classic mode: any collision ends the game
+		if (me->num_snakes == 1) {
 			GAME_reset(me);
-			return;
+			return false;
+		}
+
+		// Multi-snake mode: only the crashed snakes respawn
+		for (int i = 0; i < me->num_snakes; i++) {
+			if (dead_mask & (1U << i))
+				kill_snake(me, &me->snakes[i]);
+		}
+		for (int i = 0; i < me->num_snakes; i++) {
+			if (dead_mask & (1U << i)) {
+				spawn_snake(me, &me->snakes[i]);
+				me->game_counter++;
+				me->game_state_has_updated = true;
+			}
 		}
 	}
 
-	// 3. Food Collision
-	if (head.x == me->food.x && head.y == me->food.y) {
-		if (me->length < MAX_SNAKE_LEN) {
-			me->body[me->length] = me->body[me->length - 1];
-			me->length++; // Grow the snake
-			me->game_state_has_updated = true;
+	// 2. Food Collision
+	for (int i = 0; i < me->num_snakes; i++) {
+		SNAKE_t *snake = &me->snakes[i];
+		if (!snake->has_moved)
+			continue;
+
+		CELL_t head = SNAKE_head(snake);
+		for (int f = 0; f < me->num_snakes; f++) {
+			if (head == me->food[f]) {
+				grow_snake(me, snake); // Grow the snake
+				if (!spawn_food(me, f)) // Place new food
+					return false;
+				break;
+			}
 		}
-		spawn_food(me); // Place new food
 	}
+
+	return true;
 }
 
-void GAME_update(GAME_Engine_t *const me, key_action_e const new_action) {
+bool GAME_update_snake(GAME_Engine_t *const me, uint8_t snake_id,
+		key_action_e const new_action) {
+	if (snake_id >= me->num_snakes)
+		return false;
+
+	SNAKE_t *snake = &me->snakes[snake_id];
+	key_action_e old_dir = snake->current_dir;
+
 	// Filter input to prevent 180-degree turns
 	// Only update direction if the new direction is valid
-	if (new_action == ACTION_UP && me->current_dir != ACTION_DOWN)
-		me->current_dir = ACTION_UP;
-	else if (new_action == ACTION_DOWN && me->current_dir != ACTION_UP)
-		me->current_dir = ACTION_DOWN;
-	else if (new_action == ACTION_LEFT && me->current_dir != ACTION_RIGHT)
-		me->current_dir = ACTION_LEFT;
-	else if (new_action == ACTION_RIGHT && me->current_dir != ACTION_LEFT)
-		me->current_dir = ACTION_RIGHT;
+	if (new_action == ACTION_UP && snake->current_dir != ACTION_DOWN)
+		snake->current_dir = ACTION_UP;
+	else if (new_action == ACTION_DOWN && snake->current_dir != ACTION_UP)
+		snake->current_dir = ACTION_DOWN;
+	else if (new_action == ACTION_LEFT && snake->current_dir != ACTION_RIGHT)
+		snake->current_dir = ACTION_LEFT;
+	else if (new_action == ACTION_RIGHT && snake->current_dir != ACTION_LEFT)
+		snake->current_dir = ACTION_RIGHT;
+
+	return snake->current_dir != old_dir;
+}
+
+void GAME_update(GAME_Engine_t *const me, key_action_e const new_action) {
+	GAME_update_snake(me, 0, new_action);
 
 	// NOTE: Pause/unpause logic has been REMOVED
 	// The APP_Controller now manages game_over state externally
 }
 
 void GAME_tick(GAME_Engine_t *const me) {
-	// Don't move if no direction set (game not started yet)
-	if (me->current_dir == ACTION_NONE)
-		return;
+	me->has_moved = false;
+
+	// 1. Move every snake that has a direction (tails release first,
+	// so following another tail closely is legal)
+	for (int i = 0; i < me->num_snakes; i++) {
+		SNAKE_t *snake = &me->snakes[i];
+		snake->has_moved = false;
+
+		// Don't move if no direction set (game not started yet)
+		if (snake->current_dir == ACTION_NONE)
+			continue;
 
-	move_snake(me);
-	check_collisions(me);
+		move_snake(me, snake);
+		snake->has_moved = true;
+		me->has_moved = true;
+	}
+
+	// 2. One collision pass over all snakes (a reset clears has_moved again)
+	if (me->has_moved)
+		check_collisions(me);
 }
 
 void GAME_render(GAME_Engine_t *const me) {
 	CANVAS_clear(me->canvas);
 
 	// 1. Draw Food
-	CANVAS_draw_point(me->canvas, me->food, get_food_color(me));
+	PIXEL_t food_color = get_food_color(me);
+	for (int f = 0; f < me->num_snakes; f++) {
+		CANVAS_draw_cell(me->canvas, me->food[f], food_color);
+	}
 
-	// 2. Draw Snake
-	for (int i = 0; i < me->length; i++) {
-		CANVAS_draw_point(me->canvas, me->body[i], snake_color_lut[i]);
+	// 2. Draw Snakes
+	for (int s = 0; s < me->num_snakes; s++) {
+		SNAKE_t *snake = &me->snakes[s];
+		uint32_t hue_offset = get_snake_hue_offset(me, s);
+		for (CELL_INDEX_t i = 0; i < snake->length; i++) {
+			CANVAS_draw_cell(me->canvas, SNAKE_segment(snake, i),
+					get_snake_color(hue_offset, i));
+		}
 	}
 }
 
 void GAME_reset(GAME_Engine_t *const me) {
-	memset(me->body, 0, MAX_SNAKE_LEN * sizeof(C_COORDINATES_t));
+	memset(me->occupancy, 0, sizeof(me->occupancy));
+	me->occupied_cells = 0;
+
+	for (int f = 0; f < GAME_FOOD_POOL; f++) {
+		me->food[f] = CELL_WALL;
+	}
+
+	for (int i = 0; i < me->num_snakes; i++) {
+		spawn_snake(me, &me->snakes[i]);
+	}
 
-	me->body[0].x = rand() % DISPLAY_COLS;
-	me->body[0].y = rand() % DISPLAY_ROWS;
-	me->length = 1;
 	me->game_counter++;
-	me->current_dir = ACTION_NONE;
-	spawn_food(me);
+	me->has_moved = false;
+
+	for (int f = 0; f < me->num_snakes; f++) {
+		spawn_food(me, f);
+	}
+}
+
+void GAME_set_num_snakes(GAME_Engine_t *const me, uint8_t num_snakes) {
+	if (num_snakes < 1)
+		num_snakes = 1;
+	if (num_snakes > GAME_MAX_SNAKES)
+		num_snakes = GAME_MAX_SNAKES;
+
+	me->num_snakes = num_snakes;
+	me->game_state_has_updated = true;
+	GAME_reset(me);
+}
+
+bool GAME_is_food(const GAME_Engine_t *const me, CELL_t cell) {
+	for (int f = 0; f < me->num_snakes; f++) {
+		if (me->food[f] == cell)
+			return true;
+	}
+	return false;
+}
+
+PIXEL_t GAME_get_segment_color(GAME_Engine_t *const me, uint8_t snake_id,
+		CELL_INDEX_t index) {
+	return get_snake_color(get_snake_hue_offset(me, snake_id),
+			index % MAX_SNAKE_LEN);
 }
@@ -0,0 +1,560 @@
+/*
+ * I2C_Bus.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#include "I2C_Bus.h"
+#include "Trace.h"
+#include "Scheduler.h"
+#include <stdio.h>
+#include <string.h>
+
+#define I2C_BUS_MAX_BUSES  3           // I2C1..I2C3
+
+// Backup registers per bus for the address map: magic + map
+#define I2C_BUS_BKP_REGS   (1 + I2C_BUS_MAP_WORDS)
+
+// Transfer still in flight (not a HAL status)
+#define I2C_BUS_PENDING    ((int) -1)
+
+// HAL callbacks only carry the handle: find the bus that owns it
+static I2C_BUS_t *buses[I2C_BUS_MAX_BUSES];
+
+static I2C_BUS_t* bus_of(I2C_HandleTypeDef *hi2c) {
+	for (int i = 0; i < I2C_BUS_MAX_BUSES; i++) {
+		if (buses[i] != NULL && buses[i]->hi2c == hi2c)
+			return buses[i];
+	}
+	return NULL;
+}
+
+static void irqs_of(I2C_HandleTypeDef *hi2c, IRQn_Type *ev, IRQn_Type *er) {
+	if (hi2c->Instance == I2C2) {
+		*ev = I2C2_EV_IRQn;
+		*er = I2C2_ER_IRQn;
+	} else if (hi2c->Instance == I2C3) {
+		*ev = I2C3_EV_IRQn;
+		*er = I2C3_ER_IRQn;
+	} else {
+		*ev = I2C1_EV_IRQn;
+		*er = I2C1_ER_IRQn;
+	}
+}
+
+// Backup registers holding this bus's cached address map
+static volatile uint32_t* backup_regs(const I2C_BUS_t *const me) {
+	uint32_t index = 0;
+	if (me->hi2c->Instance == I2C2)
+		index = 1;
+	else if (me->hi2c->Instance == I2C3)
+		index = 2;
+	return &RTC->BKP0R + index * I2C_BUS_BKP_REGS;
+}
+
+// SCL/SDA pins as set up by HAL_I2C_MspInit(), for bus recovery
+static bool pins_of(I2C_HandleTypeDef *hi2c, GPIO_TypeDef **port,
+		uint16_t *scl, uint16_t *sda) {
+	if (hi2c->Instance == I2C1) {
+		*port = GPIOB;
+		*scl = GPIO_PIN_6;
+		*sda = GPIO_PIN_7;
+		return true;
+	}
+	return false;
+}
+
+// At least half a 100 kHz bit (5 us): a pass takes 4+ cycles
+static void half_bit_delay(void) {
+	for (volatile uint32_t n = SystemCoreClock / 400000U; n > 0; n--)
+		;
+}
+
+static inline uint16_t depth(const I2C_BUS_t *const me) {
+	return (uint16_t) (me->tail - me->head);
+}
+
+static uint16_t trace_arg(const I2C_BUS_Transaction_t *t) {
+	return (uint16_t) ((t->address << 8) | (t->dir == I2C_BUS_WRITE ? t->tx[0] : 0));
+}
+
+static HAL_StatusTypeDef start(I2C_BUS_t *const me, I2C_BUS_Transaction_t *t) {
+	uint16_t addr = (uint16_t) (t->address << 1);
+
+	if (t->dir == I2C_BUS_WRITE) {
+		TRACE_BEGIN_EVENT(TRACE_ID_I2C_WRITE, trace_arg(t));
+		return HAL_I2C_Master_Transmit_IT(me->hi2c, addr, t->tx, t->len);
+	}
+	TRACE_BEGIN_EVENT(TRACE_ID_I2C_READ, trace_arg(t));
+	return HAL_I2C_Master_Receive_IT(me->hi2c, addr, t->rx, t->len);
+}
+
+/* Device health ------------------------------------------------------------*/
+
+// Find the health entry for address, adding it on first use
+static I2C_BUS_Device_t* device_of(I2C_BUS_t *const me, uint8_t address) {
+	for (int i = 0; i < me->num_devices; i++) {
+		if (me->devices[i].address == address)
+			return &me->devices[i];
+	}
+	if (me->num_devices == I2C_BUS_MAX_DEVICES)
+		return NULL;
+
+	I2C_BUS_Device_t *dev = &me->devices[me->num_devices++];
+	memset(dev, 0, sizeof(*dev));
+	dev->address = address;
+	return dev;
+}
+
+// May a transaction for dev go on the bus? While down, only one probe
+// per backoff period does
+static bool device_admit(I2C_BUS_Device_t *dev) {
+	if (dev == NULL || !dev->down)
+		return true;
+	if (dev->probing || (int32_t) (HAL_GetTick() - dev->retry_at) < 0)
+		return false;
+	dev->probing = true;
+	return true;
+}
+
+static void device_record(I2C_BUS_Device_t *dev, HAL_StatusTypeDef status) {
+	if (dev == NULL)
+		return;
+
+	if (status == HAL_OK) {
+		dev->consecutive_failures = 0;
+		dev->down = false;
+		dev->probing = false;
+		return;
+	}
+
+	dev->failures++;
+	dev->report_failures++;
+	if (dev->consecutive_failures < UINT8_MAX)
+		dev->consecutive_failures++;
+
+	if (dev->down) {
+		// Failed probe (or a transaction queued before going down)
+		if (dev->probing) {
+			dev->probing = false;
+			dev->backoff_ms *= 2;
+			if (dev->backoff_ms > I2C_BUS_BACKOFF_MAX_MS)
+				dev->backoff_ms = I2C_BUS_BACKOFF_MAX_MS;
+			dev->retry_at = HAL_GetTick() + dev->backoff_ms;
+		}
+	} else if (dev->consecutive_failures >= I2C_BUS_FAIL_THRESHOLD) {
+		dev->down = true;
+		dev->backoff_ms = I2C_BUS_BACKOFF_MIN_MS;
+		dev->retry_at = HAL_GetTick() + dev->backoff_ms;
+	}
+}
+
+/* Queue --------------------------------------------------------------------*/
+
+// Pop the head transaction and report its result. Only a transaction
+// that reached the bus counts for its device's health (one flushed by a
+// reset behind a hung one says nothing about its device). Interrupts must
+// be masked; the callback runs with the bus already free for the next one
+static void finish_head(I2C_BUS_t *const me, HAL_StatusTypeDef status,
+		bool on_bus) {
+	I2C_BUS_Transaction_t *t = &me->queue[me->head & (I2C_BUS_QUEUE_SIZE - 1)];
+	I2C_BUS_done_fn done = t->done;
+	void *ctx = t->ctx;
+
+	TRACE_END_EVENT(t->dir == I2C_BUS_WRITE ? TRACE_ID_I2C_WRITE : TRACE_ID_I2C_READ,
+			status);
+	if (on_bus) {
+		device_record(t->device, status);
+	} else if (t->device != NULL) {
+		t->device->probing = false;    // A flushed probe may go again
+	}
+
+	// Restart the clock: transactions failed unstarted add nothing
+	uint32_t now = SCHED_now_us();
+	me->busy_us += now - me->started_us;
+	me->started_us = now;
+	me->head++;
+	me->busy = false;
+	if (status == HAL_OK)
+		me->completed++;
+	else
+		me->errors++;
+
+	if (done != NULL)
+		done(ctx, status);
+}
+
+// Free a slave stuck mid-byte with SDA held low: clock SCL by hand until
+// it lets go (9 clocks at most), send a STOP, then re-initialize the
+// peripheral, which hands the pins back to the I2C. Interrupts must be
+// masked
+static void recover_bus(I2C_BUS_t *const me) {
+	GPIO_TypeDef *port;
+	uint16_t scl, sda;
+
+	HAL_I2C_DeInit(me->hi2c);
+
+	if (pins_of(me->hi2c, &port, &scl, &sda)) {
+		GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+		HAL_GPIO_WritePin(port, scl | sda, GPIO_PIN_SET);
+		GPIO_InitStruct.Pin = scl | sda;
+		GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+		GPIO_InitStruct.Pull = GPIO_PULLUP;
+		GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+		HAL_GPIO_Init(port, &GPIO_InitStruct);
+		half_bit_delay();
+
+		for (int i = 0; i < 9 && HAL_GPIO_ReadPin(port, sda) == GPIO_PIN_RESET; i++) {
+			HAL_GPIO_WritePin(port, scl, GPIO_PIN_RESET);
+			half_bit_delay();
+			HAL_GPIO_WritePin(port, scl, GPIO_PIN_SET);
+			half_bit_delay();
+		}
+
+		// STOP: SDA rises while SCL is high
+		HAL_GPIO_WritePin(port, scl, GPIO_PIN_RESET);
+		half_bit_delay();
+		HAL_GPIO_WritePin(port, sda, GPIO_PIN_RESET);
+		half_bit_delay();
+		HAL_GPIO_WritePin(port, scl, GPIO_PIN_SET);
+		half_bit_delay();
+		HAL_GPIO_WritePin(port, sda, GPIO_PIN_SET);
+		half_bit_delay();
+	}
+
+	HAL_I2C_Init(me->hi2c);
+	me->recoveries++;
+}
+
+// Start the next queued transaction if the bus is free. A transaction
+// that can't be started completes at once with the HAL error; HAL_BUSY
+// means the lines are stuck low, so the bus is recovered first
+static void kick(I2C_BUS_t *const me) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	while (!me->busy && depth(me) != 0) {
+		I2C_BUS_Transaction_t *t = &me->queue[me->head & (I2C_BUS_QUEUE_SIZE - 1)];
+		me->busy = true;
+		me->started_us = SCHED_now_us();
+		HAL_StatusTypeDef status = start(me, t);
+		if (status == HAL_BUSY)
+			recover_bus(me);
+		if (status != HAL_OK)
+			finish_head(me, status, true);
+	}
+
+	__set_PRIMASK(primask);
+}
+
+// Recover the bus after a hung transfer and fail everything that was
+// queued, so no callback is left pointing at a dead caller
+static void reset_bus(I2C_BUS_t *const me) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	recover_bus(me);
+
+	// Only the head can have been on the bus
+	bool on_bus = me->busy;
+	me->busy = false;
+	while (depth(me) != 0) {
+		me->busy = true;
+		finish_head(me, HAL_TIMEOUT, on_bus);
+		on_bus = false;
+	}
+
+	__set_PRIMASK(primask);
+
+	log_message("I2C", LOG_ERROR, "Transfer timed out, bus recovered");
+}
+
+void I2C_BUS_ctor(I2C_BUS_t *const me, I2C_HandleTypeDef *hi2c) {
+	memset(me, 0, sizeof(*me));
+	me->hi2c = hi2c;
+
+	for (int i = 0; i < I2C_BUS_MAX_BUSES; i++) {
+		if (buses[i] == NULL || buses[i]->hi2c == hi2c) {
+			buses[i] = me;
+			break;
+		}
+	}
+
+	IRQn_Type ev, er;
+	irqs_of(hi2c, &ev, &er);
+	HAL_NVIC_SetPriority(ev, 0, I2C_BUS_IRQ_SUBPRIO);
+	HAL_NVIC_EnableIRQ(ev);
+	HAL_NVIC_SetPriority(er, 0, I2C_BUS_IRQ_SUBPRIO);
+	HAL_NVIC_EnableIRQ(er);
+}
+
+/* Boot discovery -----------------------------------------------------------*/
+
+static void map_set(I2C_BUS_t *const me, uint8_t address) {
+	me->present[address / 32] |= 1U << (address % 32);
+}
+
+static bool map_load(I2C_BUS_t *const me) {
+	volatile uint32_t *bkp = backup_regs(me);
+	if (bkp[0] != I2C_BUS_MAP_MAGIC)
+		return false;
+	for (int i = 0; i < I2C_BUS_MAP_WORDS; i++)
+		me->present[i] = bkp[1 + i];
+	return true;
+}
+
+static void map_store(const I2C_BUS_t *const me) {
+	volatile uint32_t *bkp = backup_regs(me);
+	for (int i = 0; i < I2C_BUS_MAP_WORDS; i++)
+		bkp[1 + i] = me->present[i];
+	bkp[0] = I2C_BUS_MAP_MAGIC;
+}
+
+static void map_log(const I2C_BUS_t *const me, uint32_t probe_ms) {
+	char list[64];
+	int len = 0;
+
+	list[0] = '\0';
+	for (uint8_t addr = I2C_BUS_PROBE_FIRST; addr <= I2C_BUS_PROBE_LAST; addr++) {
+		if (I2C_BUS_present(me, addr) && len < (int) sizeof(list) - 6)
+			len += snprintf(list + len, sizeof(list) - len, " 0x%02X", addr);
+	}
+
+	if (me->map_cached) {
+		log_message("I2C", LOG_INFO, "Address map from backup registers:%s",
+				len ? list : " none");
+	} else {
+		log_message("I2C", LOG_INFO, "Address map probed in %lu ms:%s",
+				probe_ms, len ? list : " none");
+	}
+}
+
+uint32_t I2C_BUS_discover(I2C_BUS_t *const me, bool use_cache) {
+	uint32_t start_tick = HAL_GetTick();
+
+	// Backup domain write access (registers keep their value across resets)
+	__HAL_RCC_PWR_CLK_ENABLE();
+	HAL_PWR_EnableBkUpAccess();
+
+	memset(me->present, 0, sizeof(me->present));
+	me->map_valid = true;
+	me->map_cached = use_cache && map_load(me);
+	if (me->map_cached) {
+		map_log(me, 0);
+		return 0;
+	}
+
+	bool recovered = false;
+	for (uint8_t addr = I2C_BUS_PROBE_FIRST; addr <= I2C_BUS_PROBE_LAST; addr++) {
+		HAL_StatusTypeDef status = HAL_I2C_IsDeviceReady(me->hi2c,
+				(uint16_t) (addr << 1), 1, I2C_BUS_PROBE_TIMEOUT_MS);
+
+		// BUSY stuck: one recovery, then give up instead of timing out on
+		// every address
+		if (status == HAL_BUSY && !recovered) {
+			recovered = true;
+			recover_bus(me);
+			status = HAL_I2C_IsDeviceReady(me->hi2c, (uint16_t) (addr << 1),
+					1, I2C_BUS_PROBE_TIMEOUT_MS);
+		}
+		if (status == HAL_BUSY) {
+			log_message("I2C", LOG_ERROR, "Bus stuck at 0x%02X, probe aborted",
+					addr);
+			me->map_valid = false;     // Let drivers try their addresses
+			return HAL_GetTick() - start_tick;
+		}
+
+		if (status == HAL_OK)
+			map_set(me, addr);
+	}
+
+	uint32_t probe_ms = HAL_GetTick() - start_tick;
+	map_store(me);
+	map_log(me, probe_ms);
+	return probe_ms;
+}
+
+bool I2C_BUS_present(const I2C_BUS_t *const me, uint8_t address) {
+	if (!me->map_valid)
+		return true;
+	return (me->present[(address & 0x7F) / 32] >> (address % 32)) & 1U;
+}
+
+// HAL_OK when queued, HAL_BUSY when the queue is full, HAL_ERROR when
+// the device is down or the request is invalid
+static HAL_StatusTypeDef enqueue(I2C_BUS_t *const me, uint8_t address,
+		I2C_BUS_dir_e dir, uint8_t *data, uint8_t len, I2C_BUS_done_fn done,
+		void *ctx) {
+	if (len == 0 || (dir == I2C_BUS_WRITE && len > I2C_BUS_MAX_LEN))
+		return HAL_ERROR;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (depth(me) >= I2C_BUS_QUEUE_SIZE) {
+		me->rejected++;
+		__set_PRIMASK(primask);
+		return HAL_BUSY;
+	}
+
+	I2C_BUS_Device_t *dev = device_of(me, address);
+	if (!device_admit(dev)) {
+		me->fast_failed++;
+		__set_PRIMASK(primask);
+		return HAL_ERROR;
+	}
+
+	I2C_BUS_Transaction_t *t = &me->queue[me->tail & (I2C_BUS_QUEUE_SIZE - 1)];
+	t->address = address;
+	t->dir = (uint8_t) dir;
+	t->len = len;
+	t->done = done;
+	t->ctx = ctx;
+	t->device = dev;
+	if (dir == I2C_BUS_WRITE) {
+		memcpy(t->tx, data, len);
+		t->rx = NULL;
+	} else {
+		t->rx = data;
+	}
+	me->tail++;
+
+	if (depth(me) > me->max_depth)
+		me->max_depth = depth(me);
+
+	__set_PRIMASK(primask);
+
+	kick(me);
+	return HAL_OK;
+}
+
+bool I2C_BUS_submit(I2C_BUS_t *const me, uint8_t address, I2C_BUS_dir_e dir,
+		uint8_t *data, uint8_t len, I2C_BUS_done_fn done, void *ctx) {
+	return enqueue(me, address, dir, data, len, done, ctx) == HAL_OK;
+}
+
+static void transfer_done(void *ctx, HAL_StatusTypeDef status) {
+	*(volatile int*) ctx = (int) status;
+}
+
+HAL_StatusTypeDef I2C_BUS_transfer(I2C_BUS_t *const me, uint8_t address,
+		I2C_BUS_dir_e dir, uint8_t *data, uint8_t len) {
+	volatile int result = I2C_BUS_PENDING;
+	HAL_StatusTypeDef status;
+
+	// Queue full: wait for room (the queue drains from interrupts)
+	uint32_t start_tick = HAL_GetTick();
+	while ((status = enqueue(me, address, dir, data, len, transfer_done,
+			(void*) &result)) != HAL_OK) {
+		if (status != HAL_BUSY)
+			return status;             // Device down: fail fast
+		if (HAL_GetTick() - start_tick > I2C_BUS_TIMEOUT_MS) {
+			reset_bus(me);
+			return HAL_TIMEOUT;
+		}
+	}
+
+	while (result == I2C_BUS_PENDING) {
+		if (HAL_GetTick() - start_tick > I2C_BUS_TIMEOUT_MS) {
+			reset_bus(me);   // Completes this transfer with HAL_TIMEOUT
+			break;
+		}
+	}
+
+	return (HAL_StatusTypeDef) result;
+}
+
+void I2C_BUS_poll(I2C_BUS_t *const me) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	bool hung = me->busy
+			&& (SCHED_now_us() - me->started_us) > I2C_BUS_TIMEOUT_MS * 1000U;
+	__set_PRIMASK(primask);
+
+	if (hung)
+		reset_bus(me);
+}
+
+bool I2C_BUS_idle(const I2C_BUS_t *const me) {
+	return !me->busy && depth(me) == 0;
+}
+
+const I2C_BUS_Device_t* I2C_BUS_device(const I2C_BUS_t *const me,
+		uint8_t address) {
+	for (int i = 0; i < me->num_devices; i++) {
+		if (me->devices[i].address == address)
+			return &me->devices[i];
+	}
+	return NULL;
+}
+
+uint32_t I2C_BUS_failures(const I2C_BUS_t *const me) {
+	uint32_t failures = 0;
+	for (int i = 0; i < me->num_devices; i++)
+		failures += me->devices[i].failures;
+	return failures;
+}
+
+uint32_t I2C_BUS_busy_us(const I2C_BUS_t *const me) {
+	return me->busy_us;
+}
+
+void I2C_BUS_report(I2C_BUS_t *const me) {
+	log_message("I2C", LOG_INFO,
+			"%lu transfers, %lu errors, %lu rejected, %lu fast-failed, "
+			"%lu recoveries, queue max %u/%u", me->completed, me->errors,
+			me->rejected, me->fast_failed, me->recoveries, me->max_depth,
+			I2C_BUS_QUEUE_SIZE);
+
+	// Only devices with something to say
+	for (int i = 0; i < me->num_devices; i++) {
+		I2C_BUS_Device_t *dev = &me->devices[i];
+		if (dev->down) {
+			log_message("I2C", LOG_WARN,
+					"0x%02X DOWN: %lu failures (%lu total), retry every %lu ms",
+					dev->address, dev->report_failures, dev->failures,
+					dev->backoff_ms);
+		} else if (dev->report_failures != 0) {
+			log_message("I2C", LOG_WARN, "0x%02X: %lu failures (%lu total)",
+					dev->address, dev->report_failures, dev->failures);
+		}
+		dev->report_failures = 0;
+	}
+
+	me->completed = 0;
+	me->errors = 0;
+	me->rejected = 0;
+	me->fast_failed = 0;
+	me->recoveries = 0;
+	me->max_depth = depth(me);
+}
+
+/* HAL completion callbacks (interrupt context) -----------------------------*/
+
+static void complete(I2C_HandleTypeDef *hi2c, HAL_StatusTypeDef status) {
+	I2C_BUS_t *me = bus_of(hi2c);
+	if (me == NULL)
+		return;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (me->busy)
+		finish_head(me, status, true);
+	__set_PRIMASK(primask);
+
+	kick(me);
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	complete(hi2c, HAL_OK);
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	complete(hi2c, HAL_OK);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+	complete(hi2c, HAL_ERROR);         // NACK (device absent), arbitration lost...
+}
@@ -6,11 +6,85 @@
  */
 
 #include "Input.h"
+#include "Scheduler.h"
+#include <string.h>
 
 void INPUT_ctor(INPUT_t *const me, KEYPAD_t *keypad) {
 	me->keypad = keypad;
 	me->last_raw_key = NO_KEY;
 	me->key_processed = false;
+	memset(&me->queue, 0, sizeof(me->queue));
+	me->latency_sum_us = 0;
+	me->latency_max_us = 0;
+	me->latency_count = 0;
+}
+
+// Producer side: the slot is written before tail publishes it
+static void push_event(INPUT_t *const me, INPUT_event_type_e type,
+        key_action_e action, keys_e key) {
+    INPUT_Queue_t *q = &me->queue;
+    uint8_t tail = q->tail;
+
+    if ((uint8_t) (tail - q->head) >= INPUT_QUEUE_SIZE) {
+        q->dropped++;
+        return;
+    }
+
+    INPUT_Event_t *e = &q->events[tail & (INPUT_QUEUE_SIZE - 1)];
+    e->timestamp_us = SCHED_now_us();
+    e->type = (uint8_t) type;
+    e->action = (uint8_t) action;
+    e->key = (uint8_t) key;
+
+    __DMB();
+    q->tail = tail + 1;
+}
+
+bool INPUT_pop_event(INPUT_t *const me, INPUT_Event_t *event) {
+    INPUT_Queue_t *q = &me->queue;
+    uint8_t head = q->head;
+
+    if (head == q->tail) {
+        return false;
+    }
+
+    __DMB();
+    *event = q->events[head & (INPUT_QUEUE_SIZE - 1)];
+    __DMB();
+    q->head = head + 1;
+    return true;
+}
+
+void INPUT_flush_events(INPUT_t *const me) {
+    me->queue.head = me->queue.tail;
+}
+
+void INPUT_record_latency(INPUT_t *const me, const INPUT_Event_t *event) {
+    uint32_t latency = SCHED_now_us() - event->timestamp_us;
+
+    me->latency_sum_us += latency;
+    if (latency > me->latency_max_us) {
+        me->latency_max_us = latency;
+    }
+    me->latency_count++;
+}
+
+void INPUT_report(INPUT_t *const me) {
+    if (me->latency_count == 0 && me->queue.dropped == 0) {
+        return;
+    }
+
+    uint32_t avg = me->latency_count ? me->latency_sum_us / me->latency_count : 0;
+    log_message("INPUT", LOG_INFO,
+            "%u turns, input-to-move avg %lu.%01lu ms max %lu.%01lu ms, %lu dropped",
+            me->latency_count, avg / 1000, (avg % 1000) / 100,
+            me->latency_max_us / 1000, (me->latency_max_us % 1000) / 100,
+            me->queue.dropped);
+
+    me->latency_sum_us = 0;
+    me->latency_max_us = 0;
+    me->latency_count = 0;
+    me->queue.dropped = 0;
 }
 
 key_action_e INPUT_get_action(INPUT_t *const me) {
@@ -18,6 +92,9 @@ key_action_e INPUT_get_action(INPUT_t *const me) {
 
     // 1. Handle Release: Reset state when no key is pressed
     if (current_raw == NO_KEY) {
+        if (me->last_raw_key != NO_KEY) {
+            push_event(me, INPUT_EVENT_RELEASE, ACTION_NONE, me->last_raw_key);
+        }
         me->key_processed = false;
         me->last_raw_key = NO_KEY;
         return ACTION_NONE;
@@ -44,8 +121,11 @@ key_action_e INPUT_get_action(INPUT_t *const me) {
             case S5:  action = ACTION_LEFT;  break;
             case S7:  action = ACTION_RIGHT; break;
             case S6:  action = ACTION_CONFIRM; break;
+            case S8:  action = ACTION_HUD;   break;
             default:  action = ACTION_NONE;  break;
         }
+
+        push_event(me, INPUT_EVENT_PRESS, action, current_raw);
     }
 
     return action; // Always returns a valid enum
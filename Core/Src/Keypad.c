@@ -7,14 +7,43 @@
 
 #include "Keypad.h"
 #include "debug_logger.h"
+#include "Latency.h"
 
 #define KEYPAD_PCF8574_ADDRESS (PCF8574_DEFAULT_ADDRESS | 0x02)
 
-void KEYPAD_ctor(KEYPAD_t *const me, I2C_HandleTypeDef *i2cHandle) {
+// Rows (P0-P3) all driven low, columns (P4-P7) released as inputs
+#define KEYPAD_IDLE_MASK 0xF0
+
+#if KEYPAD_USE_INT
+static KEYPAD_t *irq_keypad;
+#endif
+
+// Scan steps, each one a write + read of the expander
+enum {
+    SCAN_IDLE = 0,
+    SCAN_ANY,                          // All rows low: is any key down?
+    SCAN_ROW0,                         // .. SCAN_ROW0 + 3: find the row
+    SCAN_REARM = SCAN_ROW0 + 4         // All rows low again, re-arms INT
+};
+
+static const uint8_t row_masks[] = { 0xFE, 0xFD, 0xFB, 0xF7 };
+
+void KEYPAD_ctor(KEYPAD_t *const me, I2C_BUS_t *bus) {
 	me->driver.address = KEYPAD_PCF8574_ADDRESS;
-	PCF8574_ctor(&(me->driver), i2cHandle);
+	PCF8574_ctor(&(me->driver), bus);
 	me->key = NO_KEY;
 	me->new_key_press = false;
+	me->irq_enabled = false;
+	me->irq_pending = false;
+	me->irq_seen = false;
+	me->check_scan = false;
+	me->idle_polls = 0;
+	me->notify = NULL;
+	me->notify_ctx = NULL;
+	me->scan_step = SCAN_IDLE;
+	me->scan_error = false;
+	me->scan_done = false;
+	me->scan_result = NO_KEY;
 }
 
 static inline uint8_t col_to_int(uint8_t mask) {
@@ -32,29 +61,217 @@ static inline uint8_t col_to_int(uint8_t mask) {
 	}
 }
 
+static void scan_read_done(void *ctx, HAL_StatusTypeDef status);
+
+static void scan_write_done(void *ctx, HAL_StatusTypeDef status) {
+    if (status != HAL_OK) {
+        ((KEYPAD_t*) ctx)->scan_error = true;
+    }
+}
+
+// Drive the rows with row_mask (columns stay released) and queue a read
+// of the column bits; scan_read_done() takes it from there
+static bool read_columns(KEYPAD_t *const me, uint8_t row_mask) {
+    me->driver.set_pins.pin_byte[0] = row_mask | 0xF0;
+    return PCF8574_write_async(&(me->driver), scan_write_done, me)
+            && PCF8574_read_async(&(me->driver), scan_read_done, me);
+}
+
+static void finish_scan(KEYPAD_t *const me, keys_e key) {
+    me->scan_result = key;
+    me->scan_step = SCAN_IDLE;
+    me->scan_done = true;
+    if (me->notify != NULL) {
+        me->notify(me->notify_ctx);
+    }
+}
+
+// Bus error or full queue: keep the current key and try again on the
+// next periodic poll (no notify, a dead device must not spin the loop)
+static void abort_scan(KEYPAD_t *const me) {
+    me->irq_pending = true;
+    me->scan_step = SCAN_IDLE;
+}
+
+static void next_step(KEYPAD_t *const me, uint8_t step, uint8_t row_mask) {
+    me->scan_step = step;
+    if (!read_columns(me, row_mask)) {
+        abort_scan(me);
+    }
+}
+
+// One step of the scan, from the I2C interrupt
+static void scan_read_done(void *ctx, HAL_StatusTypeDef status) {
+    KEYPAD_t *me = ctx;
+
+    if (status != HAL_OK || me->scan_error) {
+        abort_scan(me);
+        return;
+    }
+
+    uint8_t col_mask = (me->driver.status_pins.pin_byte[0] >> 4) & 0x0F;
+    uint8_t step = me->scan_step;
+
+    // The scan's own row writes toggle the columns of a held key and
+    // raise INT too. A final all-rows-low read reflects every change up
+    // to it, so edges before it are stale
+
+    if (step == SCAN_ANY) {
+        // No column low means no key is down (2 transactions instead of
+        // 8); this read also leaves INT armed
+        if (col_mask == 0x0F) {
+            me->irq_pending = false;
+            finish_scan(me, NO_KEY);
+        } else {
+            next_step(me, SCAN_ROW0, row_masks[0]);
+        }
+        return;
+    }
+
+    if (step == SCAN_REARM) {
+        // The columns show whether any key is down; if that disagrees with
+        // the scan, a key moved in between (bounce) and no edge will
+        // report it
+        bool any_down = (col_mask != 0x0F);
+        me->irq_pending = (any_down != (me->scan_result != NO_KEY));
+        finish_scan(me, me->scan_result);
+        return;
+    }
+
+    // Row walk
+    uint8_t row = step - SCAN_ROW0;
+    keys_e detected_key = NO_KEY;
+    if (col_mask != 0x0F) {
+        uint8_t col_idx = col_to_int(col_mask);
+        if (col_idx != 0xFF) {
+            detected_key = (keys_e) ((3 - row) + (col_idx * 4));
+        }
+    }
+
+    if (detected_key == NO_KEY && row < 3) {
+        next_step(me, step + 1, row_masks[row + 1]);
+        return;
+    }
+
+    // The row walk left one row driven: back to all rows low
+    if (me->irq_enabled) {
+        me->scan_result = detected_key;
+        next_step(me, SCAN_REARM, KEYPAD_IDLE_MASK);
+    } else {
+        finish_scan(me, detected_key);
+    }
+}
+
+#if KEYPAD_USE_INT
+// A check scan found a change that raised no edge: INT is not wired
+static void fall_back_to_polling(KEYPAD_t *const me) {
+    HAL_NVIC_DisableIRQ(KEYPAD_INT_EXTI_IRQn);
+    me->irq_enabled = false;
+    me->irq_pending = false;
+    log_message("KEYPAD", LOG_WARN,
+            "Key change without an INT edge, falling back to polled scanning");
+}
+#endif
+
 void KEYPAD_poll(KEYPAD_t *const me) {
-    static uint8_t row_masks[] = { 0xFE, 0xFD, 0xFB, 0xF7 };
-    keys_e detected_key = NO_KEY; // Use a local variable
-
-    for (int i = 0; i < 4; i++) {
-        me->driver.set_pins.pin_byte[0] = row_masks[i] | 0xF0;
-        PCF8574_write(&(me->driver));
-        PCF8574_read(&(me->driver));
-
-        uint8_t col_mask = (me->driver.status_pins.pin_byte[0] >> 4) & 0x0F;
-        if (col_mask != 0x0F) {
-            uint8_t col_idx = col_to_int(col_mask);
-            if (col_idx != 0xFF) {
-                detected_key = (keys_e) ((3 - i) + (col_idx * 4));
-                break; // Exit the loop immediately once a key is found
+    // 1. Apply the scan that finished since the last poll
+    if (me->scan_done) {
+        me->scan_done = false;
+        keys_e detected_key = me->scan_result;
+
+#if KEYPAD_USE_INT
+        if (me->check_scan && !me->irq_seen && detected_key != me->key) {
+            fall_back_to_polling(me);
+        }
+        me->check_scan = false;
+#endif
+
+        if (detected_key != me->key) {
+            if (detected_key != NO_KEY) {
+                me->new_key_press = true;
+                LAT_press();
             }
+            me->key = detected_key;
         }
     }
 
-    if (detected_key != me->key) {
-        if (detected_key != NO_KEY) {
-            me->new_key_press = true;
+    // 2. One scan at a time
+    if (me->scan_step != SCAN_IDLE) {
+        return;
+    }
+
+#if KEYPAD_USE_INT
+    if (me->irq_enabled) {
+        // No edge and INT released: nothing changed, leave the bus idle.
+        // The level check also catches an edge lost while INT was held low
+        // Until an edge proves the wire, scan now and then anyway
+        if (!me->irq_pending
+                && HAL_GPIO_ReadPin(KEYPAD_INT_GPIO_Port, KEYPAD_INT_Pin) == GPIO_PIN_SET) {
+            if (me->irq_seen || ++me->idle_polls < KEYPAD_INT_CHECK_POLLS) {
+                return;
+            }
+            me->check_scan = true;
         }
-        me->key = detected_key;
+        me->idle_polls = 0;
+        me->irq_pending = false;
+    }
+#endif
+
+    // 3. Start a scan: all rows low first, the row walk only on activity
+    if (!me->irq_enabled) {
+        LAT_edge();                    // No INT: the scan is the first sign
+    }
+    me->scan_error = false;
+    next_step(me, SCAN_ANY, KEYPAD_IDLE_MASK);
+}
+
+void KEYPAD_enable_irq(KEYPAD_t *const me, KEYPAD_notify_fn notify, void *ctx) {
+    me->notify = notify;
+    me->notify_ctx = ctx;
+
+#if KEYPAD_USE_INT
+    GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+    irq_keypad = me;
+
+    // INT is open-drain, active low
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    GPIO_InitStruct.Pin = KEYPAD_INT_Pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(KEYPAD_INT_GPIO_Port, &GPIO_InitStruct);
+
+    // First poll scans once and arms INT with the rows low
+    me->irq_pending = true;
+    me->irq_enabled = true;
+
+    __HAL_GPIO_EXTI_CLEAR_IT(KEYPAD_INT_Pin);
+    HAL_NVIC_SetPriority(KEYPAD_INT_EXTI_IRQn, 0, KEYPAD_INT_IRQ_SUBPRIO);
+    HAL_NVIC_EnableIRQ(KEYPAD_INT_EXTI_IRQn);
+
+    // Nothing has confirmed the wire yet: say what this mode depends on
+    log_message("KEYPAD", LOG_WARN,
+            "INT mode assumes PCF8574 INT on PA8, unverified until the first edge");
+#endif
+}
+
+void KEYPAD_IRQHandler(void) {
+#if KEYPAD_USE_INT
+    if (__HAL_GPIO_EXTI_GET_IT(KEYPAD_INT_Pin) == 0) return;
+    __HAL_GPIO_EXTI_CLEAR_IT(KEYPAD_INT_Pin);
+
+    if (irq_keypad == NULL) return;
+
+    // Edges during a scan come from its own row writes; the final
+    // all-rows-low read settles irq_pending for anything real, and
+    // finish_scan() sends the notify that matters
+    if (irq_keypad->scan_step != SCAN_IDLE) return;
+
+    LAT_edge();
+    irq_keypad->irq_seen = true;
+    irq_keypad->irq_pending = true;
+    if (irq_keypad->notify != NULL) {
+        irq_keypad->notify(irq_keypad->notify_ctx);
     }
+#endif
 }
@@ -0,0 +1,120 @@
+/*
+ * Latency.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#include "Latency.h"
+
+#if LATENCY_PROBE
+
+#include <stdio.h>
+#include "main.h"
+#include "Scheduler.h"
+
+typedef enum {
+	LAT_IDLE = 0,
+	LAT_PRESSED,                       // Waiting for the tick
+	LAT_TURNED,                        // Waiting for the next frame
+	LAT_SENDING                        // Frame on the wire
+} LAT_state_e;
+
+typedef struct {
+	uint32_t min;
+	uint32_t max;
+	uint32_t sum;
+} LAT_Stat_t;
+
+static const char *const stage_names[LAT_NUM_STAGES] = { "poll", "tick",
+		"render", "wire" };
+
+static volatile uint32_t edge_us;      // Latest key edge (interrupt context)
+static LAT_state_e state;
+static uint32_t stamps[LAT_NUM_STAGES + 1]; // edge, press, turn, frame, sent
+
+static uint32_t samples;
+static LAT_Stat_t total;
+static LAT_Stat_t stages[LAT_NUM_STAGES];
+
+static void stat_reset(LAT_Stat_t *s) {
+	s->min = UINT32_MAX;
+	s->max = 0;
+	s->sum = 0;
+}
+
+static void stat_add(LAT_Stat_t *s, uint32_t us) {
+	if (us < s->min)
+		s->min = us;
+	if (us > s->max)
+		s->max = us;
+	s->sum += us;
+}
+
+static void reset_stats(void) {
+	samples = 0;
+	stat_reset(&total);
+	for (int i = 0; i < LAT_NUM_STAGES; i++)
+		stat_reset(&stages[i]);
+}
+
+void LAT_edge(void) {
+	edge_us = SCHED_now_us();
+}
+
+void LAT_press(void) {
+	// A press that never became a turn is simply replaced
+	stamps[0] = edge_us;
+	stamps[1] = SCHED_now_us();
+	state = LAT_PRESSED;
+}
+
+void LAT_turn(uint32_t press_us) {
+	// The input event is stamped after KEYPAD_poll(), in the same task run
+	if (state != LAT_PRESSED || (int32_t) (press_us - stamps[1]) < 0)
+		return;
+	stamps[2] = SCHED_now_us();
+	state = LAT_TURNED;
+}
+
+void LAT_frame_begin(void) {
+	if (state != LAT_TURNED)
+		return;
+	stamps[3] = SCHED_now_us();
+	state = LAT_SENDING;
+}
+
+void LAT_frame_end(void) {
+	if (state != LAT_SENDING)
+		return;
+	stamps[4] = SCHED_now_us();
+	state = LAT_IDLE;
+
+	if (samples == 0)
+		reset_stats();                 // Fresh min values
+	samples++;
+	stat_add(&total, stamps[4] - stamps[0]);
+	for (int i = 0; i < LAT_NUM_STAGES; i++)
+		stat_add(&stages[i], stamps[i + 1] - stamps[i]);
+}
+
+void LAT_report(void) {
+	if (samples == 0)
+		return;
+
+	char line[192];
+	int len = 0;
+	for (int i = 0; i < LAT_NUM_STAGES && len < (int) sizeof(line); i++) {
+		len += snprintf(line + len, sizeof(line) - len, " %s %lu/%lu/%lu",
+				stage_names[i], stages[i].min, stages[i].sum / samples,
+				stages[i].max);
+	}
+
+	log_message("LATENCY", LOG_INFO,
+			"Input-to-photon (%lu presses) min/avg/max us: total %lu/%lu/%lu |%s",
+			samples, total.min, total.sum / samples, total.max, line);
+
+	samples = 0;
+}
+
+#endif /* LATENCY_PROBE */
@@ -7,12 +7,9 @@
 
 #include "PCF8574.h"
 
-#define I2C_TIMEOUT 100
+HAL_StatusTypeDef PCF8574_ctor(PCF8574_t *const me, I2C_BUS_t *bus) {
 
-HAL_StatusTypeDef PCF8574_ctor(PCF8574_t *const me,
-		I2C_HandleTypeDef *i2cHandle) {
-
-	me->i2cHandle = i2cHandle;
+	me->bus = bus;
 
 	if(me->address == 0)
 		me->address = PCF8574_DEFAULT_ADDRESS;
@@ -22,36 +19,23 @@ HAL_StatusTypeDef PCF8574_ctor(PCF8574_t *const me,
 	log_message("PCF8574", LOG_INFO, "Initializing Device at address 0x%02X",
 			me->address);
 
-	// Try expected address first
-	HAL_StatusTypeDef status = HAL_I2C_IsDeviceReady(i2cHandle,
-			(me->address << 1), 1, I2C_TIMEOUT);
-
-	if (status != HAL_OK) {
+	// Check the boot-time address map (I2C_BUS_discover). A device missing
+	// from a cached map may have been plugged in since: probe again once
+	if (!I2C_BUS_present(bus, me->address) && bus->map_cached) {
 		log_message("PCF8574", LOG_WARN,
-				"Device not found at 0x%02X, doing one-time sweep",
-				me->address);
-
-		// One-time sweep through common PCF8574 addresses
-		for (uint8_t addr = 0x00; addr < 0x7F; addr++) {
-			status = HAL_I2C_IsDeviceReady(i2cHandle, (addr << 1), 1,
-					I2C_TIMEOUT);
-			if (status == HAL_OK) {
-				me->address = addr;
-				log_message("PCF8574", LOG_INFO, "Found Device at 0x%02X",
-						addr);
-				break;
-			} else {
-				log_message("PCF8574", LOG_WARN, "Device not found at 0x%02X",
-						addr);
-			}
-		}
-
-		if (status != HAL_OK) {
-			log_message("PCF8574", LOG_ERROR, "No PCF8574 Devices found");
-			return HAL_ERROR;
-		}
+				"0x%02X not in cached address map, probing again", me->address);
+		I2C_BUS_discover(bus, false);
+	}
+
+	// No sweep for another address: it could latch onto the other
+	// expander. The bus keeps retrying this one (device health)
+	if (!I2C_BUS_present(bus, me->address)) {
+		log_message("PCF8574", LOG_ERROR, "No PCF8574 at 0x%02X", me->address);
+		return HAL_ERROR;
 	}
 
+	HAL_StatusTypeDef status;
+
 	// Set safe defaults
 	me->set_pins.pin_byte[0] = 0x00; // All pins LOW for safety
 
@@ -76,24 +60,21 @@ HAL_StatusTypeDef PCF8574_ctor(PCF8574_t *const me,
 }
 
 HAL_StatusTypeDef PCF8574_write(PCF8574_t *const me) {
-
-	HAL_StatusTypeDef status = HAL_I2C_Master_Transmit(me->i2cHandle,
-			(me->address << 1) | 0, me->set_pins.pin_byte,
-			sizeof(me->set_pins.pin_byte), I2C_TIMEOUT);
-	if (status != HAL_OK) {
-		return status;
-	}
-
-	return HAL_OK;
+	return I2C_BUS_transfer(me->bus, me->address, I2C_BUS_WRITE,
+			me->set_pins.pin_byte, sizeof(me->set_pins.pin_byte));
 }
 
 HAL_StatusTypeDef PCF8574_read(PCF8574_t *const me) {
-	HAL_StatusTypeDef status = HAL_I2C_Master_Receive(me->i2cHandle,
-			(me->address << 1) | 1, me->status_pins.pin_byte,
-			sizeof(me->status_pins.pin_byte), I2C_TIMEOUT);
-	if (status != HAL_OK) {
-		return status;
-	}
+	return I2C_BUS_transfer(me->bus, me->address, I2C_BUS_READ,
+			me->status_pins.pin_byte, sizeof(me->status_pins.pin_byte));
+}
 
-	return HAL_OK;
+bool PCF8574_write_async(PCF8574_t *const me, I2C_BUS_done_fn done, void *ctx) {
+	return I2C_BUS_submit(me->bus, me->address, I2C_BUS_WRITE,
+			me->set_pins.pin_byte, sizeof(me->set_pins.pin_byte), done, ctx);
+}
+
+bool PCF8574_read_async(PCF8574_t *const me, I2C_BUS_done_fn done, void *ctx) {
+	return I2C_BUS_submit(me->bus, me->address, I2C_BUS_READ,
+			me->status_pins.pin_byte, sizeof(me->status_pins.pin_byte), done, ctx);
 }
@@ -0,0 +1,71 @@
+/*
+ * Profiler.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#include "Profiler.h"
+
+#if PROF_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+PROF_Stage_t PROF_stages[PROF_NUM_STAGES];
+
+static const char *const STAGE_NAMES[PROF_NUM_STAGES] = {
+	[PROF_KEYPAD_POLL] = "keypad_poll",
+	[PROF_PROCESS_INPUT] = "process_input",
+	[PROF_ALGO] = "algo",
+	[PROF_GAME_TICK] = "game_tick",
+	[PROF_GAME_RENDER] = "game_render",
+	[PROF_CANVAS_SYNC] = "canvas_sync",
+	[PROF_DISPLAY_UPDATE] = "display_update",
+	[PROF_UI_REFRESH] = "ui_refresh",
+};
+
+static void clear_stage(PROF_Stage_t *s) {
+	memset(s, 0, sizeof(*s));
+	s->min = UINT32_MAX;
+}
+
+void PROF_init(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	for (int i = 0; i < PROF_NUM_STAGES; i++) {
+		clear_stage(&PROF_stages[i]);
+		TRACE_register(TRACE_ID_STAGE_BASE + i, STAGE_NAMES[i],
+				TRACE_TRACK_STAGES);
+	}
+}
+
+void PROF_report(void) {
+	char hist[PROF_HIST_BUCKETS * 12];
+
+	for (int i = 0; i < PROF_NUM_STAGES; i++) {
+		PROF_Stage_t *s = &PROF_stages[i];
+		if (s->count == 0)
+			continue;
+
+		log_message("PROF", LOG_INFO, "%s: n=%lu min=%lu avg=%lu max=%lu cyc",
+				STAGE_NAMES[i], s->count, s->min,
+				(uint32_t) (s->sum / s->count), s->max);
+
+		// Only non-empty buckets, as "<2^b:count"
+		int len = 0;
+		hist[0] = '\0';
+		for (int b = 0; b < PROF_HIST_BUCKETS && len < (int) sizeof(hist); b++) {
+			if (s->hist[b] == 0)
+				continue;
+			len += snprintf(hist + len, sizeof(hist) - len, " <2^%d:%u", b,
+					s->hist[b]);
+		}
+		log_message("PROF", LOG_INFO, "%s hist:%s", STAGE_NAMES[i], hist);
+
+		clear_stage(s);
+	}
+}
+
+#endif /* PROF_ENABLE */
@@ -6,10 +6,14 @@
  */
 #include "SPLC780D_defs.h"
 #include "SPLC780D.h"
+#include "Trace.h"
 
 #define DELAY_COUNT 150
 #define ITTERATION_FACTOR 3 //-Ofast
 
+#define SPLC780D_BUSY_FLAG_BIT (1U << 7)   // DB7 when reading the status
+#define SPLC780D_SLOW_CMD_MS 2             // Clear / home without busy flag
+
 // Force the compiler to place the code directly inside the loop to save time
 inline void delay_cycles(uint32_t cycles) {
 	while (cycles--) {
@@ -31,17 +35,194 @@ inline void SPLC780D_Toggle_Latch(SPLC780D_t *const me) {
 	me->E_Port->BSRR = (uint32_t) me->E_Pin << 16;
 }
 
+// Clear and return home take 1.52 ms, everything else 37 us
+static inline bool is_slow_cmd(uint16_t cmd) {
+	return cmd == SPLC780D_CLEAR_CMD
+			|| (cmd & ~0x0001U) == SPLC780D_RETURN_HOME;
+}
+
+/**
+ * @brief Wait until the controller accepts the next command
+ *
+ * Releases the PCF8574 outputs (written high they are weak pull-ups the
+ * LCD can drive), reads the status with E held high and repeats until DB7
+ * drops. RW goes low again before returning, the next write re-drives
+ * the data lines.
+ */
+static void SPLC780D_wait_ready(SPLC780D_t *const me) {
+	if (!me->busy)
+		return;
+	me->busy = false;
+
+	if (!SPLC780D_USE_BUSY_FLAG || !me->busy_flag_ok) {
+		HAL_Delay(SPLC780D_SLOW_CMD_MS);
+		return;
+	}
+
+	me->data_pins.set_pins.pin_byte[0] = 0xFF;
+	if (PCF8574_write(&(me->data_pins)) != HAL_OK)
+		return;                        // Device down: nothing to wait for
+
+	HAL_GPIO_WritePin(me->RS_Port, me->RS_Pin, GPIO_PIN_RESET);
+	HAL_GPIO_WritePin(me->RW_Port, me->RW_Pin, GPIO_PIN_SET);
+
+	bool ready = false;
+	for (int i = 0; i < SPLC780D_BUSY_MAX_POLLS && !ready; i++) {
+		me->E_Port->BSRR = me->E_Pin;
+		HAL_StatusTypeDef status = PCF8574_read(&(me->data_pins));
+		me->E_Port->BSRR = (uint32_t) me->E_Pin << 16;
+
+		ready = (status != HAL_OK)
+				|| !(me->data_pins.status_pins.pin_byte[0] & SPLC780D_BUSY_FLAG_BIT);
+	}
+
+	HAL_GPIO_WritePin(me->RW_Port, me->RW_Pin, GPIO_PIN_RESET);
+
+	if (!ready) {
+		// DB7 stuck high: RW not wired or the data lines not readable
+		me->busy_flag_ok = false;
+		log_message("SPLC780D", LOG_WARN,
+				"Busy flag never cleared, using fixed delays");
+		HAL_Delay(SPLC780D_SLOW_CMD_MS);
+	}
+}
+
+// Blocking: after the queued commands, and after the previous slow one
 void SPLC780D_Write_CMD(SPLC780D_t *const me, uint16_t cmd) {
+	SPLC780D_sync(me);
+	SPLC780D_wait_ready(me);
+
+	TRACE_BEGIN_EVENT(TRACE_ID_LCD_CMD, cmd);
 	me->data_pins.set_pins.pin_byte[0] = (uint8_t) cmd & SPLC780D_CMD_BITMASK;
 	PCF8574_write(&(me->data_pins));
 	HAL_GPIO_WritePin(me->RS_Port, me->RS_Pin, CMD_TO_STATE_SPLC780D_RS(cmd));
 	HAL_GPIO_WritePin(me->RW_Port, me->RW_Pin, CMD_TO_STATE_SPLC780D_RW(cmd));
 	SPLC780D_Toggle_Latch(me);
+	TRACE_END_EVENT(TRACE_ID_LCD_CMD, cmd);
+
+	// Checked by the next command
+	me->busy = SPLC780D_POLL_EVERY_CMD || is_slow_cmd(cmd);
+}
+
+/* Command pipeline ---------------------------------------------------------*/
+
+static void pipe_data_written(void *ctx, HAL_StatusTypeDef status);
+
+// Start the PCF8574 write of the command at q_head. Interrupts masked or
+// called from the I2C interrupt. A command that can't be submitted (LCD
+// down) is dropped so the queue still drains
+static void pipe_pump(SPLC780D_t *const me) {
+	while (me->q_head != me->q_tail) {
+		uint16_t cmd = me->queue[me->q_head & (SPLC780D_QUEUE_SIZE - 1)];
+
+		TRACE_BEGIN_EVENT(TRACE_ID_LCD_CMD, cmd);
+		me->data_pins.set_pins.pin_byte[0] = (uint8_t) cmd & SPLC780D_CMD_BITMASK;
+
+		// Set first: a transfer that fails to start completes right here
+		me->pipe_busy = true;
+		if (PCF8574_write_async(&(me->data_pins), pipe_data_written, me))
+			return;
+
+		TRACE_END_EVENT(TRACE_ID_LCD_CMD, cmd);
+		me->q_head++;
+		me->dropped++;
+	}
+	me->pipe_busy = false;
+}
+
+// Data lines are set: latch the command and send the next one
+static void pipe_data_written(void *ctx, HAL_StatusTypeDef status) {
+	SPLC780D_t *me = ctx;
+
+	// Nothing outstanding: never step q_head past q_tail
+	if (me->q_head == me->q_tail) {
+		me->pipe_busy = false;
+		return;
+	}
+
+	uint16_t cmd = me->queue[me->q_head & (SPLC780D_QUEUE_SIZE - 1)];
+
+	if (status == HAL_OK) {
+		HAL_GPIO_WritePin(me->RS_Port, me->RS_Pin, CMD_TO_STATE_SPLC780D_RS(cmd));
+		HAL_GPIO_WritePin(me->RW_Port, me->RW_Pin, CMD_TO_STATE_SPLC780D_RW(cmd));
+		SPLC780D_Toggle_Latch(me);
+	} else {
+		me->dropped++;
+	}
+	TRACE_END_EVENT(TRACE_ID_LCD_CMD, cmd);
+
+	me->q_head++;
+	pipe_pump(me);
+}
+
+// Queue a short (37 us) command. The next PCF8574 write takes longer than
+// that, so queued commands need no busy check
+static void pipe_queue(SPLC780D_t *const me, uint16_t cmd) {
+#if SPLC780D_POLL_EVERY_CMD
+	// Busy check before every command: only the blocking path can do it
+	SPLC780D_Write_CMD(me, cmd);
+	return;
+#endif
+
+	// After a blocking slow command the queue is empty: wait for it here
+	SPLC780D_wait_ready(me);
+
+	uint32_t start_tick = HAL_GetTick();
+	while ((uint16_t) (me->q_tail - me->q_head) >= SPLC780D_QUEUE_SIZE) {
+		if (HAL_GetTick() - start_tick > SPLC780D_SYNC_TIMEOUT_MS) {
+			me->dropped++;
+			return;
+		}
+	}
+
+	me->queue[me->q_tail & (SPLC780D_QUEUE_SIZE - 1)] = cmd;
+	__DMB();
+	me->q_tail++;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (!me->pipe_busy)
+		pipe_pump(me);
+	__set_PRIMASK(primask);
+}
+
+bool SPLC780D_idle(const SPLC780D_t *const me) {
+	return !me->pipe_busy && me->q_head == me->q_tail;
 }
 
+void SPLC780D_report(SPLC780D_t *const me) {
+	if (me->dropped == 0)
+		return;
+
+	log_message("SPLC780D", LOG_WARN, "%lu commands dropped", me->dropped);
+	me->dropped = 0;
+}
+
+void SPLC780D_sync(SPLC780D_t *const me) {
+	uint32_t start_tick = HAL_GetTick();
+
+	while (!SPLC780D_idle(me)) {
+		if (HAL_GetTick() - start_tick > SPLC780D_SYNC_TIMEOUT_MS) {
+			// Completion never came (bus hung): forget the commands behind
+			// the one in flight. That PCF8574 write is still queued on the
+			// bus; its callback retires it once the transfer completes or
+			// the bus is reset
+			uint32_t primask = __get_PRIMASK();
+			__disable_irq();
+			uint16_t keep = me->pipe_busy ? 1 : 0;
+			me->dropped += (uint16_t) (me->q_tail - me->q_head - keep);
+			me->q_tail = me->q_head + keep;
+			__set_PRIMASK(primask);
+			log_message("SPLC780D", LOG_ERROR, "Command queue stalled, dropped");
+			return;
+		}
+	}
+}
+
+/* Commands -----------------------------------------------------------------*/
+
 void SPLC780D_Clear(SPLC780D_t *const me){
-	SPLC780D_Write_CMD(me, SPLC780D_CLEAR_CMD);
-	HAL_Delay(2); // VERY IMPORTANT: Clear needs ~2ms
+	SPLC780D_Write_CMD(me, SPLC780D_CLEAR_CMD); // ~1.52 ms, waited for by the next command
 	me->cursor_x = 0;
 	me->cursor_y = 0;
 }
@@ -49,6 +230,9 @@ void SPLC780D_Clear(SPLC780D_t *const me){
 //Follow Page 10
 void SPLC780D_Reset(SPLC780D_t *const me) {
 
+	// The busy flag can't be read until the third Function Set
+	me->busy = false;
+
 	// 1. First Function Set (Forcing 8-bit mode)
 	SPLC780D_Write_CMD(me, SPLC780D_FUNCTION_SET);
 	HAL_Delay(5); // Wait more than 4.1ms
@@ -57,8 +241,9 @@ void SPLC780D_Reset(SPLC780D_t *const me) {
 	SPLC780D_Write_CMD(me, SPLC780D_FUNCTION_SET);
 	HAL_Delay(1); // Wait more than 100us
 
-	// 3. Third Function Set
+	// 3. Third Function Set, from here on the busy flag is valid
 	SPLC780D_Write_CMD(me, SPLC780D_FUNCTION_SET);
+	me->busy = SPLC780D_USE_BUSY_FLAG;
 
 	// 4. Final Function Set (Set rows/font)
 	// 0x38 = 8-bit mode, 2-line display, 5x8 font
@@ -70,10 +255,16 @@ void SPLC780D_Reset(SPLC780D_t *const me) {
 	SPLC780D_Write_CMD(me, SPLC780D_ENTRY_MODE_SET);
 }
 
-void SPLC780D_ctor(SPLC780D_t *const me, I2C_HandleTypeDef *i2chandle) {
+void SPLC780D_ctor(SPLC780D_t *const me, I2C_BUS_t *bus) {
 
 	me->data_pins.address = SPLC780D_PCF8574_ADDRESS;
-	PCF8574_ctor(&(me->data_pins), i2chandle);
+	PCF8574_ctor(&(me->data_pins), bus);
+	me->busy = false;
+	me->busy_flag_ok = true;
+	me->q_head = 0;
+	me->q_tail = 0;
+	me->pipe_busy = false;
+	me->dropped = 0;
 
 	// Wait at least 40ms after VCC rises to 4.5V
 	HAL_Delay(50);
@@ -98,12 +289,27 @@ void SPLC780D_move_cursor(SPLC780D_t *const me, uint8_t x, uint8_t y) {
 	}
 	uint8_t addr =
 			(y == 0) ? (SPLC780D_LINE_1_BASE + x) : (SPLC780D_LINE_2_BASE + x);
-	SPLC780D_Write_CMD(me, SPLC780D_DDRAM_SET | (addr & SPLC780D_DDRAM_ADDR_MSK));
+	pipe_queue(me, SPLC780D_DDRAM_SET | (addr & SPLC780D_DDRAM_ADDR_MSK));
 
 	me->cursor_x = x;
 	me->cursor_y = y;
 }
 
 void SPLC780D_write_char(SPLC780D_t * const me, const char data){
-	SPLC780D_Write_CMD(me,SPLC780D_WRITE_DATA_TO_RAM | data);
+	pipe_queue(me, SPLC780D_WRITE_DATA_TO_RAM | (uint8_t) data);
+}
+
+void SPLC780D_define_glyph(SPLC780D_t *const me, uint8_t index,
+		const uint8_t rows[8]) {
+	if (index >= SPLC780D_NUM_GLYPHS) {
+		log_message("SPLC780D", LOG_ERROR, "Glyph %u out of range", index);
+		return;
+	}
+
+	// Data writes go to CGRAM (8 bytes per glyph) until the next DDRAM set
+	pipe_queue(me, SPLC780D_CGRAM_SET | ((index << 3) & SPLC780D_CGRAM_ADDR_MSK));
+	for (int row = 0; row < 8; row++) {
+		pipe_queue(me, SPLC780D_WRITE_DATA_TO_RAM | (rows[row] & 0x1F));
+	}
+	SPLC780D_move_cursor(me, me->cursor_x, me->cursor_y);
 }
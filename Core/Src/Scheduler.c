@@ -0,0 +1,321 @@
+/*
+ * Scheduler.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#include "Scheduler.h"
+#include "main.h"
+#include "Trace.h"
+
+// Time base: TIM2 (32-bit) free-running at 1 MHz, wraps every ~71 minutes.
+// HAL TIM is not enabled in this project, so the timer is set up directly.
+#define SCHED_TIMER              TIM2
+#define SCHED_TIMER_IRQn         TIM2_IRQn
+// NVIC_PRIORITYGROUP_0: no preemption bits, so no interrupt preempts
+// another; the sub-priority only orders pending ones. Only wakes the core
+#define SCHED_TIMER_IRQ_SUBPRIO  1
+
+// Longest single sleep when no task is registered
+#define SCHED_MAX_SLEEP_US       SCHED_US_PER_S
+
+static void timebase_init(void) {
+	__HAL_RCC_TIM2_CLK_ENABLE();
+
+	// APB1 timers run at 2x PCLK1 whenever the APB1 prescaler is not 1
+	uint32_t timer_clk = HAL_RCC_GetPCLK1Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+		timer_clk *= 2;
+
+	SCHED_TIMER->CR1 = 0;
+	SCHED_TIMER->PSC = timer_clk / SCHED_US_PER_S - 1;
+	SCHED_TIMER->ARR = 0xFFFFFFFF;
+	SCHED_TIMER->CNT = 0;
+	SCHED_TIMER->EGR = TIM_EGR_UG;       // Load the prescaler now
+	SCHED_TIMER->SR = 0;
+	SCHED_TIMER->DIER = 0;               // Compare IRQ is armed only while asleep
+	SCHED_TIMER->CR1 = TIM_CR1_CEN;
+
+	HAL_NVIC_SetPriority(SCHED_TIMER_IRQn, 0, SCHED_TIMER_IRQ_SUBPRIO);
+	HAL_NVIC_EnableIRQ(SCHED_TIMER_IRQn);
+
+#ifdef DEBUG
+	// Keep the debugger attached while the core sleeps in WFI
+	HAL_DBGMCU_EnableDBGSleepMode();
+#endif
+}
+
+static void set_period(SCHED_Task_t *const task, uint32_t rate_hz) {
+	if (rate_hz == 0)
+		rate_hz = 1;
+	if (rate_hz > SCHED_US_PER_S)
+		rate_hz = SCHED_US_PER_S;
+
+	task->rate_hz = rate_hz;
+	task->period_us = SCHED_US_PER_S / rate_hz;
+	task->period_rem = SCHED_US_PER_S % rate_hz;
+	task->rem_acc = 0;
+}
+
+// Length of the next period: whole microseconds plus one extra every time
+// the accumulated remainder reaches a full microsecond
+static uint32_t next_period(SCHED_Task_t *const task) {
+	uint32_t period = task->period_us;
+
+	task->rem_acc += task->period_rem;
+	if (task->rem_acc >= task->rate_hz) {
+		task->rem_acc -= task->rate_hz;
+		period++;
+	}
+	return period;
+}
+
+static inline uint32_t deadline_of(const SCHED_Task_t *task) {
+	return (task->deadline_us != 0) ? task->deadline_us : task->period_us;
+}
+
+static void reset_stats(SCHED_Task_t *const task) {
+	task->runs = 0;
+	task->deadline_misses = 0;
+	task->overruns = 0;
+	task->caught_up = 0;
+	task->skipped = 0;
+	task->triggers = 0;
+	task->latency_sum_us = 0;
+	task->latency_max_us = 0;
+	task->exec_max_us = 0;
+}
+
+static void run_task(SCHED_Task_t *const task, uint32_t now) {
+	uint32_t release = task->next_release;
+
+	// An early run (SCHED_trigger) leaves the periodic releases in place;
+	// a trigger arriving while the task runs releases it once more
+	bool early = task->triggered && (int32_t) (release - now) > 0;
+	task->triggered = false;
+	if (early) {
+		release = now;
+		task->triggers++;
+	} else {
+		task->next_release = release + next_period(task);
+	}
+
+	uint32_t latency = now - release;
+	task->last_release = release;
+
+	TRACE_BEGIN_EVENT(task->trace_id, 0);
+	task->run(task->ctx);
+	TRACE_END_EVENT(task->trace_id, 0);
+
+	uint32_t end = SCHED_now_us();
+	uint32_t exec = end - now;
+
+	// Keep the events that led up to a stall for TRACE_dump()
+	if (task->stall_watch && exec >= TRACE_STALL_US)
+		TRACE_freeze();
+
+	task->runs++;
+	if (latency >= task->period_us)
+		task->caught_up++;      // Started a whole period late (missed release)
+	if (exec > task->period_us)
+		task->overruns++;
+	task->latency_sum_us += latency;
+	if (latency > task->latency_max_us)
+		task->latency_max_us = latency;
+	if (exec > task->exec_max_us)
+		task->exec_max_us = exec;
+	if (end - release > deadline_of(task))
+		task->deadline_misses++;
+
+	// Late by whole periods: keep at most max_catchup + 1 releases due
+	// (they run back-to-back next), drop the older ones
+	uint32_t backlog_us = task->period_us * (task->max_catchup + 1U);
+	while ((int32_t) (end - task->next_release) >= (int32_t) backlog_us) {
+		task->next_release += next_period(task);
+		task->skipped++;
+	}
+}
+
+static bool any_triggered(const SCHED_t *const me) {
+	for (int i = 0; i < me->num_tasks; i++) {
+		if (me->tasks[i]->triggered)
+			return true;
+	}
+	return false;
+}
+
+static void sleep_until(SCHED_t *const me, uint32_t wake) {
+	// Interrupts stay masked from arming to WFI so a wake-up can't be lost;
+	// a pending interrupt still ends WFI and runs once they are unmasked
+	__disable_irq();
+	SCHED_TIMER->CCR1 = wake;
+	SCHED_TIMER->SR = ~TIM_SR_CC1IF;
+	SCHED_TIMER->DIER |= TIM_DIER_CC1IE;
+
+	uint32_t start = SCHED_now_us();
+
+	// The compare only fires on an exact match: never sleep past it, nor
+	// past a trigger that came in after SCHED_run() looked at the tasks
+	if ((int32_t) (wake - start) > 0 && !any_triggered(me))
+		__WFI();
+
+	uint32_t end = SCHED_now_us();
+	__enable_irq();
+
+	me->idle_us += end - start;
+	me->load_idle_us += end - start;
+}
+
+static void update_load(SCHED_t *const me, uint32_t now) {
+	uint32_t elapsed = now - me->load_start;
+	if (elapsed < SCHED_LOAD_WINDOW_US)
+		return;
+
+	uint32_t idle = (me->load_idle_us < elapsed) ? me->load_idle_us : elapsed;
+	me->load_percent = (uint8_t) (100U
+			- (uint32_t) (((uint64_t) idle * 100U) / elapsed));
+	me->load_idle_us = 0;
+	me->load_start = now;
+}
+
+void SCHED_ctor(SCHED_t *const me) {
+	me->num_tasks = 0;
+	me->idle_us = 0;
+
+	me->load_idle_us = 0;
+	me->load_percent = 0;
+
+	timebase_init();
+	me->report_start = SCHED_now_us();
+	me->load_start = me->report_start;
+}
+
+void SCHED_add_task(SCHED_t *const me, SCHED_Task_t *task, const char *name,
+		SCHED_task_fn run, void *ctx, uint32_t rate_hz, uint32_t phase_us,
+		uint32_t deadline_us) {
+	if (me->num_tasks >= SCHED_MAX_TASKS) {
+		log_message("SCHED", LOG_ERROR, "No room for task %s", name);
+		return;
+	}
+
+	task->name = name;
+	task->run = run;
+	task->ctx = ctx;
+	task->trace_id = TRACE_ID_TASK_BASE + me->num_tasks;
+	task->deadline_us = deadline_us;
+	task->max_catchup = 0;
+	task->stall_watch = true;
+	task->triggered = false;
+	set_period(task, rate_hz);
+
+	task->next_release = SCHED_now_us() + phase_us;
+	task->last_release = task->next_release;
+	reset_stats(task);
+	TRACE_register(task->trace_id, name, TRACE_TRACK_TASKS);
+
+	me->tasks[me->num_tasks++] = task;
+}
+
+void SCHED_set_rate(SCHED_Task_t *const task, uint32_t rate_hz) {
+	if (rate_hz == task->rate_hz)
+		return;
+
+	set_period(task, rate_hz);
+	task->next_release = task->last_release + next_period(task);
+}
+
+void SCHED_set_catchup(SCHED_Task_t *const task, uint8_t max_catchup) {
+	task->max_catchup = max_catchup;
+}
+
+void SCHED_set_stall_watch(SCHED_Task_t *const task, bool watch) {
+	task->stall_watch = watch;
+}
+
+void SCHED_trigger(SCHED_Task_t *const task) {
+	task->triggered = true;
+}
+
+void SCHED_run(SCHED_t *const me) {
+	uint32_t now = SCHED_now_us();
+	SCHED_Task_t *ready = NULL;
+	int32_t ready_slack = INT32_MAX;
+	int32_t until_next = SCHED_MAX_SLEEP_US;
+
+	update_load(me, now);
+
+	for (int i = 0; i < me->num_tasks; i++) {
+		SCHED_Task_t *task = me->tasks[i];
+		int32_t until_release = (int32_t) (task->next_release - now);
+
+		if (task->triggered && until_release > 0)
+			until_release = 0;
+
+		if (until_release <= 0) {
+			// Released: earliest absolute deadline goes first
+			int32_t slack = until_release + (int32_t) deadline_of(task);
+			if (slack < ready_slack) {
+				ready_slack = slack;
+				ready = task;
+			}
+		} else if (until_release < until_next) {
+			until_next = until_release;
+		}
+	}
+
+	if (ready != NULL)
+		run_task(ready, now);
+	else
+		sleep_until(me, now + until_next);
+}
+
+void SCHED_report(SCHED_t *const me) {
+	uint32_t now = SCHED_now_us();
+	uint32_t elapsed = now - me->report_start;
+
+	for (int i = 0; i < me->num_tasks; i++) {
+		SCHED_Task_t *task = me->tasks[i];
+		uint32_t latency_avg = (task->runs != 0) ?
+				task->latency_sum_us / task->runs : 0;
+
+		log_message("SCHED", LOG_INFO,
+				"%s: %lu Hz, %lu runs (%lu triggered), latency avg %lu max %lu us, exec max %lu us, %lu missed, %lu overrun, %lu caught up, %lu skipped",
+				task->name, task->rate_hz, task->runs, task->triggers,
+				latency_avg, task->latency_max_us, task->exec_max_us,
+				task->deadline_misses, task->overruns, task->caught_up,
+				task->skipped);
+
+		// Logic falling behind changes game speed: make it stand out
+		if (task->skipped != 0 && task->max_catchup != 0) {
+			log_message("SCHED", LOG_WARN,
+					"%s dropped %lu releases beyond catch-up cap %u",
+					task->name, task->skipped, task->max_catchup);
+		}
+		reset_stats(task);
+	}
+
+	if (elapsed != 0) {
+		log_message("SCHED", LOG_INFO, "Idle (WFI): %lu%% of %lu ms",
+				(uint32_t) (((uint64_t) me->idle_us * 100) / elapsed),
+				elapsed / 1000);
+	}
+
+	me->idle_us = 0;
+	me->report_start = now;
+}
+
+uint8_t SCHED_cpu_load(const SCHED_t *const me) {
+	return me->load_percent;
+}
+
+uint32_t SCHED_now_us(void) {
+	return SCHED_TIMER->CNT;
+}
+
+void SCHED_IRQHandler(void) {
+	if (SCHED_TIMER->SR & TIM_SR_CC1IF) {
+		SCHED_TIMER->SR = ~TIM_SR_CC1IF;
+		SCHED_TIMER->DIER &= ~TIM_DIER_CC1IE; // One-shot, re-armed before each sleep
+	}
+}
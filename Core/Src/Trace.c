@@ -0,0 +1,131 @@
+/*
+ * Trace.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ */
+
+#include "Trace.h"
+
+#if TRACE_ENABLE
+
+#include <string.h>
+#include "main.h"
+
+#define TRACE_VERSION       1
+#define TRACE_UART_TIMEOUT  1000
+
+extern UART_HandleTypeDef huart2;
+
+typedef struct {
+	const char *name;
+	uint8_t track;
+} TRACE_Name_t;
+
+static TRACE_Event_t events[TRACE_BUFFER_SIZE];
+static uint32_t head;                  // Total events recorded (wraps)
+static uint32_t armed_at;              // head value from which freezes count
+static volatile bool frozen;
+static TRACE_Name_t names[TRACE_MAX_IDS];
+
+void TRACE_init(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	head = 0;
+	armed_at = TRACE_BUFFER_SIZE;
+	frozen = false;
+	memset(names, 0, sizeof(names));
+
+	TRACE_register(TRACE_ID_I2C_WRITE, "i2c_write", TRACE_TRACK_I2C);
+	TRACE_register(TRACE_ID_I2C_READ, "i2c_read", TRACE_TRACK_I2C);
+	TRACE_register(TRACE_ID_LCD_CMD, "lcd_cmd", TRACE_TRACK_LCD);
+	TRACE_register(TRACE_ID_STATE, "app_state", TRACE_TRACK_APP);
+}
+
+void TRACE_register(uint8_t id, const char *name, TRACE_track_e track) {
+	if (id >= TRACE_MAX_IDS)
+		return;
+	names[id].name = name;
+	names[id].track = (uint8_t) track;
+}
+
+void TRACE_record(TRACE_type_e type, uint8_t id, uint16_t arg) {
+	if (frozen)
+		return;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	TRACE_Event_t *e = &events[head & (TRACE_BUFFER_SIZE - 1)];
+	e->timestamp = DWT->CYCCNT;
+	e->type = (uint8_t) type;
+	e->id = id;
+	e->arg = arg;
+	head++;
+
+	__set_PRIMASK(primask);
+}
+
+void TRACE_freeze(void) {
+	// Don't freeze on a ring that still holds the previous dump's tail
+	// (the dump itself is a long stall)
+	if ((int32_t) (head - armed_at) >= 0)
+		frozen = true;
+}
+
+static void send(const void *data, uint16_t len) {
+	if (len == 0)
+		return;
+	HAL_UART_Transmit(&huart2, (uint8_t*) data, len, TRACE_UART_TIMEOUT);
+}
+
+bool TRACE_dump(void) {
+	if (!frozen)
+		return false;
+
+	uint16_t count = (head < TRACE_BUFFER_SIZE) ? head : TRACE_BUFFER_SIZE;
+	uint32_t oldest = head - count;
+
+	// Header: magic, version, event count, cycle clock
+	uint16_t version = TRACE_VERSION;
+	uint32_t clock_hz = SystemCoreClock;
+	send("TRCE", 4);
+	send(&version, sizeof(version));
+	send(&count, sizeof(count));
+	send(&clock_hz, sizeof(clock_hz));
+
+	// Name table: id, track, length, characters
+	uint8_t num_names = 0;
+	for (int id = 0; id < TRACE_MAX_IDS; id++) {
+		if (names[id].name != NULL)
+			num_names++;
+	}
+	send(&num_names, 1);
+	for (int id = 0; id < TRACE_MAX_IDS; id++) {
+		if (names[id].name == NULL)
+			continue;
+		uint8_t entry[3] = { (uint8_t) id, names[id].track,
+				(uint8_t) strlen(names[id].name) };
+		send(entry, sizeof(entry));
+		send(names[id].name, entry[2]);
+	}
+
+	// Events, oldest first (little-endian, 8 bytes each): up to the end
+	// of the array, then the wrapped part from the start
+	uint32_t first = oldest & (TRACE_BUFFER_SIZE - 1);
+	uint32_t tail_count = TRACE_BUFFER_SIZE - first;
+	if (tail_count > count)
+		tail_count = count;
+	send(&events[first], tail_count * sizeof(TRACE_Event_t));
+	send(&events[0], (count - tail_count) * sizeof(TRACE_Event_t));
+	send("TEND", 4);
+
+	log_message("TRACE", LOG_INFO, "Dumped %u events", count);
+
+	armed_at = head + TRACE_BUFFER_SIZE;
+	frozen = false;
+	return true;
+}
+
+#endif /* TRACE_ENABLE */
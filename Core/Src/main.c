@@ -24,17 +24,52 @@
 #include "Algo.h"
 #include <stdlib.h>
 #include "App_Controller.h"
+#include "Effects.h"
 #include "FPS_counter_util.h"
+#include "Scheduler.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "I2C_Bus.h"
+#include "Latency.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
 
+// Everything the scheduled tasks touch (objects live in main())
+typedef struct {
+	KEYPAD_t *keypad;
+	APP_Controller_t *controller;
+	GAME_Engine_t *game;
+	EFFECTS_t *effects;
+	CANVAS_t *canvas;
+	DISPLAY_t *pixel_display;
+	APP_UI_t *ui;
+	FPS_Counter_t *fps;
+	SCHED_t *sched;
+	I2C_BUS_t *i2c_bus;
+	INPUT_t *input;
+	CHAR_DISPLAY_t *char_display;
+	SCHED_Task_t *tick_task;
+	SCHED_Task_t *render_task;
+
+	// LED update time for the performance HUD, since its last sample
+	uint32_t wire_us_sum;
+	uint32_t wire_frames;
+} MAIN_Tasks_Context_t;
+
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
 
+// Scheduler stats are logged over UART this often
+#define SCHED_REPORT_INTERVAL_S 10
+
+// Game ticks replayed back-to-back after a stall (LCD flush, I2C timeout,
+// slow AI decision) so game speed stays exact; beyond this the game slows
+#define TICK_MAX_CATCHUP 4
+
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -62,6 +97,169 @@ static void MX_I2C1_Init(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+
+/* ========================================================================
+ * SCHEDULED TASKS
+ * ======================================================================== */
+
+/**
+ * @brief INPUT PROCESSING (INPUT_RATE)
+ */
+static void input_task(void *arg) {
+	MAIN_Tasks_Context_t *ctx = arg;
+
+	// 1. Poll hardware
+	PROF_BEGIN(PROF_KEYPAD_POLL);
+	KEYPAD_poll(ctx->keypad);
+	PROF_END(PROF_KEYPAD_POLL);
+
+	// 2. Controller routes input to appropriate subsystem
+	// - In MANUAL mode: directions are queued for the next game tick
+	// - In AI mode: input only for menu/settings
+	PROF_BEGIN(PROF_PROCESS_INPUT);
+	APP_CONTROLLER_process_input(ctx->controller);
+	PROF_END(PROF_PROCESS_INPUT);
+
+	// 3. Follow the game's dynamic tick rate (mode toggles happen above)
+	SCHED_set_rate(ctx->tick_task, ctx->game->level_tick_rate);
+}
+
+/**
+ * @brief GAME LOGIC UPDATE (Dynamic: 5Hz for manual, 15Hz for AI)
+ */
+static void tick_task(void *arg) {
+	MAIN_Tasks_Context_t *ctx = arg;
+
+	// Controller handles both MANUAL and AI mode:
+	// - MANUAL: Takes one queued turn from process_input
+	// - AI: Makes decision HERE at tick rate, then ticks game
+	APP_CONTROLLER_update(ctx->controller);
+}
+
+/**
+ * @brief RENDERING (RENDER_RATE)
+ */
+static void render_task(void *arg) {
+	MAIN_Tasks_Context_t *ctx = arg;
+
+	// 1. Render game and update UI stats
+	APP_CONTROLLER_render(ctx->controller);
+
+	// 2. Blend the cells changed by the last tick using the sub-tick
+	// phase: time since the tick was released, one frame ahead so it
+	// reaches EFFECTS_PHASE_FULL on the frame before the next tick
+	uint32_t tick_period = ctx->tick_task->period_us;
+	uint32_t since_tick = SCHED_now_us() - ctx->tick_task->last_release
+			+ ctx->render_task->period_us;
+	uint8_t tick_phase = EFFECTS_PHASE_FULL;
+	if (since_tick < tick_period)
+		tick_phase = (uint8_t) ((since_tick * EFFECTS_PHASE_FULL) / tick_period);
+	EFFECTS_apply(ctx->effects, tick_phase);
+
+	// 3. Push canvas to hardware
+	PROF_BEGIN(PROF_CANVAS_SYNC);
+	CANVAS_sync(ctx->canvas);
+	PROF_END(PROF_CANVAS_SYNC);
+
+	// 4. Track FPS
+	uint32_t display_fps = FPS_tick(ctx->fps, SCHED_now_us());
+
+	// 5. Update display hardware
+	PROF_BEGIN(PROF_DISPLAY_UPDATE);
+	LAT_frame_begin();
+	uint32_t wire_start = SCHED_now_us();
+	DISPLAY_update(ctx->pixel_display);
+	ctx->wire_us_sum += SCHED_now_us() - wire_start;
+	ctx->wire_frames++;
+	LAT_frame_end();
+	PROF_END(PROF_DISPLAY_UPDATE);
+
+	// 6-8. FPS, CPU load and I2C failures on the character LCD (the
+	// widgets skip values they already show)
+	APP_UI_update_int(ctx->ui, GAME_FPS, display_fps);
+	APP_UI_update_int(ctx->ui, CPU_LOAD, SCHED_cpu_load(ctx->sched));
+	APP_UI_update_int(ctx->ui, I2C_ERRORS, I2C_BUS_failures(ctx->i2c_bus));
+
+	// 9. Refresh UI if needed
+	PROF_BEGIN(PROF_UI_REFRESH);
+	APP_UI_refresh(ctx->ui);
+	PROF_END(PROF_UI_REFRESH);
+}
+
+/**
+ * @brief Keypad INT edge or finished scan (interrupt context): poll on the
+ *        next loop pass instead of waiting for the next INPUT_RATE release
+ */
+static void keypad_wake_input(void *arg) {
+	SCHED_trigger((SCHED_Task_t*) arg);
+}
+
+/**
+ * @brief One performance HUD sample: averages since the previous one
+ */
+static void perf_hud_sample(MAIN_Tasks_Context_t *ctx) {
+	static uint32_t last_now_us = 0;
+	static uint32_t last_busy_us = 0;
+
+	uint32_t now_us = SCHED_now_us();
+	uint32_t busy_us = I2C_BUS_busy_us(ctx->i2c_bus);
+	uint32_t elapsed_us = now_us - last_now_us;
+
+	FPS_Pacing_t pacing;
+	FPS_get_pacing(ctx->fps, &pacing);
+
+	APP_UI_Perf_t perf = { .frame_us = pacing.avg_us, .frame_budget_us =
+			ctx->render_task->period_us, .cpu_pct = SCHED_cpu_load(ctx->sched), };
+	if (ctx->wire_frames != 0)
+		perf.wire_us = ctx->wire_us_sum / ctx->wire_frames;
+	if (elapsed_us != 0) {
+		uint32_t i2c_pct = (uint32_t) (((uint64_t) (busy_us - last_busy_us) * 100)
+				/ elapsed_us);
+		perf.i2c_pct = (i2c_pct > 100) ? 100 : (uint8_t) i2c_pct;
+	}
+
+	APP_UI_update_perf(ctx->ui, &perf);
+
+	last_now_us = now_us;
+	last_busy_us = busy_us;
+	ctx->wire_us_sum = 0;
+	ctx->wire_frames = 0;
+}
+
+/**
+ * @brief TRACE DUMP, I2C WATCHDOG AND PERFORMANCE HUD (1 Hz), SCHEDULER,
+ *        FRAME PACING, TICK TIMING, I2C, INPUT, LCD AND PROFILER STATS
+ *        (every SCHED_REPORT_INTERVAL_S)
+ */
+static void report_task(void *arg) {
+	MAIN_Tasks_Context_t *ctx = arg;
+	static uint8_t seconds = 0;
+
+	// Send the trace ring if a stall froze it
+	TRACE_dump();
+
+	// Unwedge an asynchronous transfer that never completed
+	I2C_BUS_poll(ctx->i2c_bus);
+
+	// Performance HUD page (kept up to date while hidden too)
+	perf_hud_sample(ctx);
+
+	if (++seconds >= SCHED_REPORT_INTERVAL_S) {
+		seconds = 0;
+		SCHED_report(ctx->sched);
+		FPS_report(ctx->fps);
+		APP_CONTROLLER_report(ctx->controller);
+		I2C_BUS_report(ctx->i2c_bus);
+		INPUT_report(ctx->input);
+#if CHAR_DISPLAY_USE_DIRTY_TRACKING
+		CHAR_DISPLAY_report(ctx->char_display);
+#endif
+		SPLC780D_report(ctx->char_display->driver);
+		LAT_report();
+		PROF_report();
+	}
+}
+
 /* USER CODE END 0 */
 
 /**
@@ -96,24 +294,49 @@ int main(void) {
 	MX_I2C1_Init();
 	/* USER CODE BEGIN 2 */
 
+	// Event trace first, so driver bring-up is recorded too
+	TRACE_init();
+
 	/* ========================================================================
 	 * HARDWARE DRIVER INITIALIZATION
 	 * ======================================================================== */
 
+	// Boot-time breakdown (HAL_GetTick() ms since reset)
+	uint32_t boot_start = HAL_GetTick();
+
 	// Pixel Display (WS2812B LED Matrix)
 	DISPLAY_t my_pixel_display;
 	DISPLAY_ctor(&my_pixel_display, WS2812B_D_GPIO_Port, WS2812B_D_Pin);
+	uint32_t boot_display = HAL_GetTick();
+
+	// I2C transaction queue shared by the keypad and LCD expanders
+	static I2C_BUS_t my_i2c_bus; // Holds the transaction queue, keep off the stack
+	I2C_BUS_ctor(&my_i2c_bus, &hi2c1);
+
+	// Address map for the expander constructors (cached across warm boots)
+	I2C_BUS_discover(&my_i2c_bus, true);
+	uint32_t boot_discovery = HAL_GetTick();
 
 	// Keypad (4x4 matrix via PCF8574)
 	KEYPAD_t my_keypad;
-	KEYPAD_ctor(&my_keypad, &hi2c1);
+	KEYPAD_ctor(&my_keypad, &my_i2c_bus);
+	uint32_t boot_keypad = HAL_GetTick();
 
 	// Character LCD Display (40x2 via SPLC780D)
-	SPLC780D_t my_char_display_driver = { .E_Port = SPLC780D_E_GPIO_Port,
+	// Holds the command queue, keep off the stack
+	static SPLC780D_t my_char_display_driver = { .E_Port = SPLC780D_E_GPIO_Port,
 			.E_Pin = SPLC780D_E_Pin, .RW_Port = SPLC780D_RW_GPIO_Port, .RW_Pin =
 			SPLC780D_RW_Pin, .RS_Port = SPLC780D_RS_GPIO_Port, .RS_Pin =
 			SPLC780D_RS_Pin, };
-	SPLC780D_ctor(&my_char_display_driver, &hi2c1);
+	SPLC780D_ctor(&my_char_display_driver, &my_i2c_bus);
+	uint32_t boot_lcd = HAL_GetTick();
+
+	log_message("MAIN", LOG_INFO,
+			"Boot: HAL/clocks %lu ms, LEDs %lu ms, I2C discovery %lu ms (%s), "
+			"keypad %lu ms, LCD %lu ms, total %lu ms", boot_start,
+			boot_display - boot_start, boot_discovery - boot_display,
+			my_i2c_bus.map_cached ? "cached" : "probed",
+			boot_keypad - boot_discovery, boot_lcd - boot_keypad, boot_lcd);
 
 	/* ========================================================================
 	 * ABSTRACTION LAYER INITIALIZATION
@@ -145,18 +368,23 @@ int main(void) {
 	APP_UI_force_refresh(&app_ui);
 
 	// Game Engine
-	GAME_Engine_t my_game_engine;
+	static GAME_Engine_t my_game_engine; // Sized for GAME_MAX_SNAKES, keep off the stack
 	GAME_ctor(&my_game_engine, &my_canvas);
 
-	// AI Player (always initialized - toggle via UI)
-	ALGO_t my_algo_player;
-	ALGO_ctor(&my_algo_player, &my_game_engine);
-	log_message("MAIN", LOG_INFO, "AI player initialized and ready");
+	// AI Players, one per snake (always initialized - toggle via UI)
+	static ALGO_t my_algo_players[GAME_MAX_SNAKES];
+	for (uint8_t i = 0; i < GAME_MAX_SNAKES; i++) {
+		ALGO_ctor(&my_algo_players[i], &my_game_engine, i);
+	}
+	log_message("MAIN", LOG_INFO, "AI players initialized and ready");
+
+	// Motion blending between game ticks
+	EFFECTS_t my_effects;
+	EFFECTS_ctor(&my_effects, &my_game_engine);
 
-	// FPS Counter
-	FPS_Counter_t fps_counter;
+	// FPS Counter and frame pacing window
+	static FPS_Counter_t fps_counter; // Holds the frame time window, keep off the stack
 	FPS_ctor(&fps_counter, 1000);
-	static char fps_string[16];
 
 	/* ========================================================================
 	 * TOP-LEVEL APPLICATION CONTROLLER
@@ -164,7 +392,44 @@ int main(void) {
 
 	APP_Controller_t app_controller;
 	APP_CONTROLLER_ctor(&app_controller, &my_game_engine, &app_ui, &my_input,
-			&my_algo_player);
+			my_algo_players);
+
+	/* ========================================================================
+	 * TASK SCHEDULER
+	 * ======================================================================== */
+
+	static SCHED_t scheduler;
+	static SCHED_Task_t input, tick, render, report;
+
+	MAIN_Tasks_Context_t tasks = { .keypad = &my_keypad, .controller =
+			&app_controller, .game = &my_game_engine, .effects = &my_effects,
+			.canvas = &my_canvas, .pixel_display = &my_pixel_display, .ui =
+					&app_ui, .fps = &fps_counter, .sched = &scheduler, .i2c_bus = &my_i2c_bus,
+			.input = &my_input, .char_display = &my_char_display,
+			.tick_task = &tick, .render_task = &render, };
+
+	SCHED_ctor(&scheduler);
+	PROF_init();
+
+	// Phase offsets keep the render frame clear of the input poll and the
+	// stats report; the tick runs with the input poll it depends on
+	SCHED_add_task(&scheduler, &input, "input", input_task, &tasks,
+			INPUT_RATE, 0, 0);
+	SCHED_add_task(&scheduler, &tick, "tick", tick_task, &tasks,
+			my_game_engine.level_tick_rate, 0, 0);
+	SCHED_set_catchup(&tick, TICK_MAX_CATCHUP); // Logic catches up, render skips
+	SCHED_add_task(&scheduler, &render, "render", render_task, &tasks,
+			RENDER_RATE, SCHED_US_PER_S / RENDER_RATE / 2, 0);
+	SCHED_add_task(&scheduler, &report, "report", report_task, &tasks, 1,
+			SCHED_US_PER_S / 2, 0);
+	// Its UART logs and the trace dump take hundreds of ms by design: only
+	// stalls of the other tasks freeze the trace ring
+	SCHED_set_stall_watch(&report, false);
+
+	// Keypad scans only after a PCF8574 INT edge. The edge and the end of
+	// each (interrupt-driven) scan run the input task right away instead
+	// of at its next 30 Hz release
+	KEYPAD_enable_irq(&my_keypad, keypad_wake_input, &input);
 
 	/* ========================================================================
 	 * SETUP COMPLETE
@@ -173,9 +438,6 @@ int main(void) {
 	srand(HAL_GetTick());
 	log_message("MAIN", LOG_INFO, "System initialized, entering main loop");
 
-	uint32_t last_tick = 0;
-	uint8_t counter_input = 0, counter_render = 0, counter_tick = 0;
-
 	/* USER CODE END 2 */
 
 	/* Infinite loop */
@@ -184,71 +446,9 @@ int main(void) {
 		/* USER CODE END WHILE */
 
 		/* USER CODE BEGIN 3 */
-		uint32_t now = HAL_GetTick();
-
-		if (now - last_tick >= (1000 / REFRESH_RATE)) { // 60 FPS
-			last_tick = now;
-
-			/* ================================================================
-			 * INPUT PROCESSING (30 Hz)
-			 * ================================================================ */
-			if (++counter_input >= REFRESH_RATE / INPUT_RATE) {
-				counter_input = 0;
-
-				// 1. Poll hardware
-				KEYPAD_poll(&my_keypad);
-
-				// 2. Controller routes input to appropriate subsystem
-				// - In MANUAL mode: input goes to game
-				// - In AI mode: input only for menu/settings
-				APP_CONTROLLER_process_input(&app_controller);
-			}
-
-			/* ================================================================
-			 * GAME LOGIC UPDATE (Dynamic: 5Hz for manual, 15Hz for AI)
-			 * ================================================================ */
-			// Use dynamic tick rate from game engine
-			uint8_t current_tick_rate = my_game_engine.level_tick_rate;
-			if (++counter_tick >= REFRESH_RATE / current_tick_rate) {
-				counter_tick = 0;
-
-				// Controller handles both MANUAL and AI mode:
-				// - MANUAL: Uses direction set by process_input
-				// - AI: Makes decision HERE at tick rate, then ticks game
-				APP_CONTROLLER_update(&app_controller);
-			}
-
-			/* ================================================================
-			 * RENDERING (60 Hz)
-			 * ================================================================ */
-			if (++counter_render >= REFRESH_RATE / RENDER_RATE) {
-				counter_render = 0;
-
-				// 1. Render game and update UI stats
-				APP_CONTROLLER_render(&app_controller);
-
-				// 2. Push canvas to hardware
-				CANVAS_sync(&my_canvas);
-
-				// 3. Track FPS
-				uint32_t display_fps = FPS_tick(&fps_counter, now);
-
-				// 4. Update display hardware
-				DISPLAY_update(&my_pixel_display);
-
-				// 5. Display FPS on character LCD
-				static uint32_t last_fps = 0;
-				if (display_fps != last_fps) {
-					snprintf(fps_string, sizeof(fps_string), "%lu",
-							display_fps);
-					APP_UI_update_value(&app_ui, GAME_FPS, fps_string);
-					last_fps = display_fps;
-				}
-
-				// 6. Refresh UI if needed
-				APP_UI_refresh(&app_ui);
-			}
-		}
+
+		// Run whatever task is due, sleep (WFI) until the next release otherwise
+		SCHED_run(&scheduler);
 	}
 	/* USER CODE END 3 */
 }
@@ -22,6 +22,8 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "Scheduler.h"
+#include "Keypad.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -57,6 +59,7 @@
 /* External variables --------------------------------------------------------*/
 
 /* USER CODE BEGIN EV */
+extern I2C_HandleTypeDef hi2c1;
 
 /* USER CODE END EV */
 
@@ -200,4 +203,36 @@ void SysTick_Handler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles TIM2 global interrupt (scheduler time base).
+  */
+void TIM2_IRQHandler(void)
+{
+  SCHED_IRQHandler();
+}
+
+/**
+  * @brief This function handles EXTI line[9:5] interrupts (keypad INT).
+  */
+void EXTI9_5_IRQHandler(void)
+{
+  KEYPAD_IRQHandler();
+}
+
+/**
+  * @brief This function handles I2C1 event interrupt (I2C_Bus queue).
+  */
+void I2C1_EV_IRQHandler(void)
+{
+  HAL_I2C_EV_IRQHandler(&hi2c1);
+}
+
+/**
+  * @brief This function handles I2C1 error interrupt (I2C_Bus queue).
+  */
+void I2C1_ER_IRQHandler(void)
+{
+  HAL_I2C_ER_IRQHandler(&hi2c1);
+}
+
 /* USER CODE END 1 */
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Board-size RAM/flash budget report.
+
+Compiles the board-size dependent modules once per configuration with
+-DBOARD_COLS/-DBOARD_ROWS and reads symbol sizes back with nm. Prints a
+markdown table per configuration.
+
+Usage (from the repository root):
+    python3 Tools/board_budget.py                 # default configurations
+    python3 Tools/board_budget.py 8x24 16x16      # explicit configurations
+    CC=arm-none-eabi-gcc NM=arm-none-eabi-nm python3 Tools/board_budget.py
+
+Use the ARM toolchain for code sizes that match the target; data sizes
+are the same on any compiler except for embedded pointers.
+"""
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+DEFAULT_CONFIGS = ["8x24", "16x16", "32x32"]
+
+# Modules whose footprint depends on the board size
+SOURCES = [
+    "Core/Src/Cell.c",
+    "Core/Src/Color.c",
+    "Core/Src/Game.c",
+    "Core/Src/Algo.c",
+    "Core/Src/Canvas.c",
+    "Tools/board_budget_probe.c",
+]
+
+INCLUDES = [
+    "Core/Inc",
+    "Drivers/STM32F4xx_HAL_Driver/Inc",
+    "Drivers/STM32F4xx_HAL_Driver/Inc/Legacy",
+    "Drivers/CMSIS/Device/ST/STM32F4xx/Include",
+    "Drivers/CMSIS/Include",
+]
+
+RAM_TYPES = "bBdDsScC"
+FLASH_DATA_TYPES = "rR"
+CODE_TYPES = "tT"
+
+
+def find_tool(env, candidates):
+    if os.environ.get(env):
+        return os.environ[env]
+    for tool in candidates:
+        if shutil.which(tool):
+            return tool
+    sys.exit("No %s found (tried %s)" % (env, ", ".join(candidates)))
+
+
+def compile_config(cc, cols, rows, outdir):
+    objects = []
+    for src in SOURCES:
+        obj = os.path.join(outdir, os.path.basename(src) + ".o")
+        cmd = [cc, "-c", "-Os", "-std=gnu11", "-w",
+               "-DSTM32F411xE", "-DUSE_HAL_DRIVER",
+               "-DBOARD_COLS=%d" % cols, "-DBOARD_ROWS=%d" % rows,
+               "-fno-common", "-ffunction-sections", "-fdata-sections",
+               "-o", obj, os.path.join(ROOT, src)]
+        if "arm-none-eabi" in cc:
+            cmd += ["-mcpu=cortex-m4", "-mthumb", "-mfpu=fpv4-sp-d16", "-mfloat-abi=hard"]
+        for inc in INCLUDES:
+            cmd.append("-I" + os.path.join(ROOT, inc))
+        subprocess.run(cmd, check=True)
+        objects.append(obj)
+    return objects
+
+
+def read_symbols(nm, objects):
+    symbols = []
+    out = subprocess.run([nm, "-S", "-t", "d"] + objects,
+                         check=True, capture_output=True, text=True).stdout
+    module = None
+    for line in out.splitlines():
+        if line.endswith(".o:"):
+            module = os.path.basename(line[:-3]).replace(".c.o", "").replace(".o", "")
+            continue
+        parts = line.split()
+        if len(parts) != 4:
+            continue
+        _, size, kind, name = parts
+        symbols.append((module, name, kind, int(size)))
+    return symbols
+
+
+def report(cols, rows, symbols, cc):
+    cells = cols * rows
+    width = 8 if cells <= 255 else 16
+    print("## %dx%d board (%d cells, %d-bit cell ids)\n" % (cols, rows, cells, width))
+    print("| Region | Object | Bytes |")
+    print("|---|---|---:|")
+
+    totals = {"RAM": 0, "Flash data": 0, "Flash code": 0}
+    for module, name, kind, size in sorted(symbols, key=lambda s: -s[3]):
+        if name.startswith("budget_static_"):
+            region, label = "RAM", "%s (main static .bss)" % name[len("budget_static_"):]
+        elif name.startswith("budget_heap_"):
+            region, label = "RAM", "%s (heap)" % name[len("budget_heap_"):]
+        elif kind in RAM_TYPES:
+            region, label = "RAM", "%s:%s" % (module, name)
+        elif kind in FLASH_DATA_TYPES:
+            region, label = "Flash data", "%s:%s" % (module, name)
+        elif kind in CODE_TYPES:
+            totals["Flash code"] += size
+            continue
+        else:
+            continue
+        totals[region] += size
+        print("| %s | %s | %d |" % (region, label, size))
+
+    for region, size in totals.items():
+        print("| **%s total** | | **%d** |" % (region, size))
+    print("\nCode sizes from `%s`.\n" % cc)
+
+
+def main():
+    configs = sys.argv[1:] or DEFAULT_CONFIGS
+    cc = find_tool("CC", ["arm-none-eabi-gcc", "gcc", "cc"])
+    nm = find_tool("NM", ["arm-none-eabi-nm", "nm"])
+
+    for config in configs:
+        cols, rows = (int(v) for v in config.lower().split("x"))
+        with tempfile.TemporaryDirectory() as outdir:
+            objects = compile_config(cc, cols, rows, outdir)
+            report(cols, rows, read_symbols(nm, objects), cc)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,22 @@
+/*
+ * board_budget_probe.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: rayv_mini_pc
+ *
+ * Host/cross compiled by board_budget.py only, never linked into the
+ * firmware. Each object below mirrors a board-size dependent allocation
+ * that does not show up as a symbol in the modules the tool compiles
+ * (main() function statics and calloc'd buffers), so its size can be
+ * read back with nm.
+ */
+
+#include "Algo.h"
+
+// main() function statics (.bss)
+GAME_Engine_t budget_static_game_engine;
+ALGO_t budget_static_algo_players[GAME_MAX_SNAKES];
+
+// Heap: CANVAS_ctor() and DISPLAY_ctor() buffers
+PIXEL_t budget_heap_canvas_buffer[CELL_COUNT];
+PIXEL_t budget_heap_display_buffer[CELL_COUNT];
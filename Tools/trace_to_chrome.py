@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+Convert trace dumps from the UART log into Chrome trace JSON.
+
+The firmware (Core/Src/Trace.c) freezes its event ring when a task
+stalls and sends it in binary, framed by "TRCE" ... "TEND", on the same
+UART as the text log. Capture the raw serial stream to a file, e.g.
+
+    python3 -m serial.tools.miniterm --raw /dev/ttyACM0 115200 > capture.bin
+
+or any terminal's binary logging, then convert (from the repository root):
+
+    python3 Tools/trace_to_chrome.py capture.bin trace.json
+
+Open trace.json in chrome://tracing or https://ui.perfetto.dev. Every
+dump in the capture becomes its own process row ("dump 1", "dump 2"...).
+
+Dump layout (little-endian):
+    "TRCE" u16 version  u16 count  u32 clock_hz
+    u8 num_names, then per name: u8 id, u8 track, u8 len, len bytes
+    count x { u32 cycles, u8 type, u8 id, u16 arg }
+    "TEND"
+"""
+
+import json
+import struct
+import sys
+
+MAGIC = b"TRCE"
+END_MAGIC = b"TEND"
+SUPPORTED_VERSION = 1
+
+EVENT = struct.Struct("<IBBH")
+HEADER = struct.Struct("<HHI")
+
+TYPE_BEGIN, TYPE_END, TYPE_INSTANT = 0, 1, 2
+PHASES = {TYPE_BEGIN: "B", TYPE_END: "E", TYPE_INSTANT: "i"}
+
+# Mirrors TRACE_track_e in Core/Inc/Trace.h
+TRACKS = {1: "tasks", 2: "stages", 3: "i2c", 4: "lcd", 5: "app"}
+
+# Mirrors APP_State_e in Core/Inc/App_Controller.h
+APP_STATES = ["MENU", "PLAYING", "PAUSED", "GAME_OVER"]
+
+
+def parse_dump(data, pos):
+    """Parse one dump starting after its magic. Returns (dump, next_pos)."""
+    version, count, clock_hz = HEADER.unpack_from(data, pos)
+    pos += HEADER.size
+    if version != SUPPORTED_VERSION:
+        raise ValueError("unsupported trace version %d" % version)
+
+    names = {}
+    num_names = data[pos]
+    pos += 1
+    for _ in range(num_names):
+        ident, track, length = data[pos], data[pos + 1], data[pos + 2]
+        pos += 3
+        names[ident] = (data[pos:pos + length].decode("ascii", "replace"), track)
+        pos += length
+
+    events = []
+    for _ in range(count):
+        events.append(EVENT.unpack_from(data, pos))
+        pos += EVENT.size
+
+    if data[pos:pos + len(END_MAGIC)] != END_MAGIC:
+        raise ValueError("missing end marker (truncated capture?)")
+    pos += len(END_MAGIC)
+
+    return {"clock_hz": clock_hz, "names": names, "events": events}, pos
+
+
+def find_dumps(data):
+    dumps = []
+    pos = data.find(MAGIC)
+    while pos >= 0:
+        try:
+            dump, end = parse_dump(data, pos + len(MAGIC))
+            dumps.append(dump)
+        except (ValueError, IndexError, struct.error) as err:
+            print("skipping dump at byte %d: %s" % (pos, err), file=sys.stderr)
+            end = pos + len(MAGIC)
+        pos = data.find(MAGIC, end)
+    return dumps
+
+
+def describe(name, event_type, arg):
+    """Extra args shown in the viewer's detail pane."""
+    if name.startswith("i2c"):
+        if event_type == TYPE_BEGIN:
+            return {"address": "0x%02X" % (arg >> 8), "data": "0x%02X" % (arg & 0xFF)}
+        return {"status": arg}
+    if name == "lcd_cmd":
+        return {"cmd": "0x%03X" % arg}
+    if name == "app_state":
+        state = APP_STATES[arg] if arg < len(APP_STATES) else str(arg)
+        return {"state": state}
+    return {}
+
+
+def to_chrome(dumps):
+    trace = []
+    for pid, dump in enumerate(dumps, start=1):
+        trace.append({"name": "process_name", "ph": "M", "pid": pid,
+                      "args": {"name": "dump %d" % pid}})
+        for track, label in TRACKS.items():
+            trace.append({"name": "thread_name", "ph": "M", "pid": pid,
+                          "tid": track, "args": {"name": label}})
+
+        cycles_per_us = dump["clock_hz"] / 1e6
+        events = dump["events"]
+        last = events[0][0] if events else 0
+        unwrapped = 0
+        for cycles, event_type, ident, arg in events:
+            # DWT->CYCCNT wraps every ~43 s at 100 MHz
+            unwrapped += (cycles - last) & 0xFFFFFFFF
+            last = cycles
+
+            name, track = dump["names"].get(ident, ("id_%d" % ident, 1))
+            event = {
+                "name": name,
+                "ph": PHASES.get(event_type, "i"),
+                "ts": unwrapped / cycles_per_us,
+                "pid": pid,
+                "tid": track,
+            }
+            if event["ph"] == "i":
+                event["s"] = "t"
+            args = describe(name, event_type, arg)
+            if args:
+                event["args"] = args
+            trace.append(event)
+    return {"traceEvents": trace, "displayTimeUnit": "ms"}
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: %s capture.bin trace.json" % sys.argv[0])
+
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+
+    dumps = find_dumps(data)
+    if not dumps:
+        sys.exit("no trace dumps found in %s" % sys.argv[1])
+
+    with open(sys.argv[2], "w") as f:
+        json.dump(to_chrome(dumps), f)
+
+    total = sum(len(d["events"]) for d in dumps)
+    print("%d dump(s), %d events -> %s" % (len(dumps), total, sys.argv[2]))
+
+
+if __name__ == "__main__":
+    main()